@@ -0,0 +1,30 @@
+# deskgui - A powerful and flexible C++ library to create web-based desktop applications.
+# Copyright (c) 2023 deskgui
+# MIT License
+
+# Decoders for resource packs compiled with resource_compiler(... COMPRESSION <codec>).
+# Every codec is optional: a webview answers requests for resources encoded with a codec that
+# was not found at build time with an error.
+
+add_library(ResourceDecoders INTERFACE)
+
+find_package(ZLIB QUIET)
+if (ZLIB_FOUND)
+  target_link_libraries(ResourceDecoders INTERFACE ZLIB::ZLIB)
+  target_compile_definitions(ResourceDecoders INTERFACE DESKGUI_HAS_ZLIB)
+endif()
+
+find_package(PkgConfig QUIET)
+if (PkgConfig_FOUND)
+  pkg_check_modules(brotlidec QUIET IMPORTED_TARGET libbrotlidec)
+  if (brotlidec_FOUND)
+    target_link_libraries(ResourceDecoders INTERFACE PkgConfig::brotlidec)
+    target_compile_definitions(ResourceDecoders INTERFACE DESKGUI_HAS_BROTLI)
+  endif()
+
+  pkg_check_modules(zstd QUIET IMPORTED_TARGET libzstd)
+  if (zstd_FOUND)
+    target_link_libraries(ResourceDecoders INTERFACE PkgConfig::zstd)
+    target_compile_definitions(ResourceDecoders INTERFACE DESKGUI_HAS_ZSTD)
+  endif()
+endif()
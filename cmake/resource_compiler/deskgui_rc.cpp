@@ -0,0 +1,413 @@
+/**
+ * deskgui - A powerful and flexible C++ library to create web-based desktop applications.
+ *
+ * Copyright (c) 2023 deskgui
+ * MIT License
+ */
+
+// deskgui_rc - Native generator of the compiled resource sources, used by resource_compiler()
+// instead of generate_resources.py -m resources when it can be built for the host. The sources
+// are identical to the ones of resource_content.py: one translation unit per resource, holding
+// its bytes (a hex array or an .incbin of a blob file) and its ResourceEntry. Resources are
+// generated in parallel and files are only rewritten when their content changes.
+//
+//   deskgui_rc -o <output dir> -p <pack name> -f <resource>... [-c gzip|br|zstd]
+//              [-e incbin|hex] [-j <threads>]
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#ifdef DESKGUI_HAS_ZLIB
+#  include <zlib.h>
+#endif
+
+#ifdef DESKGUI_HAS_BROTLI
+#  include <brotli/encode.h>
+#endif
+
+#ifdef DESKGUI_HAS_ZSTD
+#  include <zstd.h>
+#endif
+
+#include "utils/mime_types.h"
+
+namespace {
+
+  using Bytes = std::vector<std::uint8_t>;
+
+  struct Options {
+    std::filesystem::path outputDir;
+    std::string packName;
+    std::vector<std::string> resourceFiles;
+    std::string compression;
+    std::string embed{"hex"};
+    unsigned threads{std::max(1u, std::thread::hardware_concurrency())};
+  };
+
+  // SHA-256 (FIPS 180-4), the generated symbols and ETags are its first 32 hex digits.
+  class Sha256 {
+  public:
+    static std::string hex32(const Bytes& data) {
+      Sha256 sha;
+      sha.update(data.data(), data.size());
+      const auto digest = sha.finish();
+      static constexpr char kDigits[] = "0123456789abcdef";
+      std::string hex;
+      for (std::size_t i = 0; i < 16; ++i) {
+        hex += kDigits[digest[i] >> 4];
+        hex += kDigits[digest[i] & 0xF];
+      }
+      return hex;
+    }
+
+  private:
+    static constexpr std::array<std::uint32_t, 64> kRounds{
+        0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4,
+        0xab1c5ed5, 0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe,
+        0x9bdc06a7, 0xc19bf174, 0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f,
+        0x4a7484aa, 0x5cb0a9dc, 0x76f988da, 0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7,
+        0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967, 0x27b70a85, 0x2e1b2138, 0x4d2c6dfc,
+        0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85, 0xa2bfe8a1, 0xa81a664b,
+        0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070, 0x19a4c116,
+        0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+        0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7,
+        0xc67178f2};
+
+    static std::uint32_t rotate(std::uint32_t value, int bits) {
+      return (value >> bits) | (value << (32 - bits));
+    }
+
+    void update(const std::uint8_t* data, std::size_t size) {
+      length_ += size;
+      while (size > 0) {
+        const auto count = std::min(size, block_.size() - used_);
+        std::copy(data, data + count, block_.begin() + used_);
+        used_ += count;
+        data += count;
+        size -= count;
+        if (used_ == block_.size()) {
+          compress();
+          used_ = 0;
+        }
+      }
+    }
+
+    std::array<std::uint8_t, 32> finish() {
+      const std::uint64_t bits = length_ * 8;
+      const std::uint8_t padding = 0x80;
+      update(&padding, 1);
+      const std::uint8_t zero = 0;
+      while (used_ != 56) update(&zero, 1);
+      for (int i = 7; i >= 0; --i) {
+        const auto byte = static_cast<std::uint8_t>(bits >> (i * 8));
+        update(&byte, 1);
+      }
+      std::array<std::uint8_t, 32> digest{};
+      for (std::size_t i = 0; i < 8; ++i) {
+        for (std::size_t j = 0; j < 4; ++j) {
+          digest[i * 4 + j] = static_cast<std::uint8_t>(state_[i] >> (24 - j * 8));
+        }
+      }
+      return digest;
+    }
+
+    void compress() {
+      std::array<std::uint32_t, 64> w{};
+      for (std::size_t i = 0; i < 16; ++i) {
+        w[i] = static_cast<std::uint32_t>(block_[i * 4]) << 24
+               | static_cast<std::uint32_t>(block_[i * 4 + 1]) << 16
+               | static_cast<std::uint32_t>(block_[i * 4 + 2]) << 8 | block_[i * 4 + 3];
+      }
+      for (std::size_t i = 16; i < 64; ++i) {
+        const auto s0 = rotate(w[i - 15], 7) ^ rotate(w[i - 15], 18) ^ (w[i - 15] >> 3);
+        const auto s1 = rotate(w[i - 2], 17) ^ rotate(w[i - 2], 19) ^ (w[i - 2] >> 10);
+        w[i] = w[i - 16] + s0 + w[i - 7] + s1;
+      }
+      auto [a, b, c, d, e, f, g, h] = state_;
+      for (std::size_t i = 0; i < 64; ++i) {
+        const auto t1 = h + (rotate(e, 6) ^ rotate(e, 11) ^ rotate(e, 25)) + ((e & f) ^ (~e & g))
+                        + kRounds[i] + w[i];
+        const auto t2
+            = (rotate(a, 2) ^ rotate(a, 13) ^ rotate(a, 22)) + ((a & b) ^ (a & c) ^ (b & c));
+        h = g;
+        g = f;
+        f = e;
+        e = d + t1;
+        d = c;
+        c = b;
+        b = a;
+        a = t1 + t2;
+      }
+      const std::array<std::uint32_t, 8> add{a, b, c, d, e, f, g, h};
+      for (std::size_t i = 0; i < 8; ++i) state_[i] += add[i];
+    }
+
+    std::array<std::uint32_t, 8> state_{0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a,
+                                        0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19};
+    std::array<std::uint8_t, 64> block_{};
+    std::size_t used_{0};
+    std::uint64_t length_{0};
+  };
+
+  Bytes readFile(const std::filesystem::path& path) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file) throw std::runtime_error("cannot read " + path.string());
+    return Bytes(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+  }
+
+  // Leaves files holding the same data untouched, so the build does not recompile them.
+  void writeIfChanged(const std::filesystem::path& path, std::string_view data) {
+    std::error_code error;
+    if (std::filesystem::file_size(path, error) == data.size() && !error) {
+      const auto current = readFile(path);
+      if (std::equal(current.begin(), current.end(), data.begin(), data.end(),
+                     [](std::uint8_t a, char b) { return a == static_cast<std::uint8_t>(b); })) {
+        return;
+      }
+    }
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    file.write(data.data(), static_cast<std::streamsize>(data.size()));
+    if (!file) throw std::runtime_error("cannot write " + path.string());
+  }
+
+  std::optional<Bytes> compress(const Bytes& data, const std::string& compression) {
+#ifdef DESKGUI_HAS_ZLIB
+    if (compression == "gzip") {
+      // Same settings as gzip.compress(compresslevel=9, mtime=0): the header has no timestamp.
+      z_stream stream{};
+      if (deflateInit2(&stream, 9, Z_DEFLATED, 16 + MAX_WBITS, 8, Z_DEFAULT_STRATEGY) != Z_OK) {
+        return std::nullopt;
+      }
+      Bytes output(deflateBound(&stream, static_cast<uLong>(data.size())));
+      stream.next_in = const_cast<Bytef*>(data.data());
+      stream.avail_in = static_cast<uInt>(data.size());
+      stream.next_out = output.data();
+      stream.avail_out = static_cast<uInt>(output.size());
+      const int result = deflate(&stream, Z_FINISH);
+      output.resize(stream.total_out);
+      deflateEnd(&stream);
+      if (result != Z_STREAM_END) return std::nullopt;
+      return output;
+    }
+#endif
+#ifdef DESKGUI_HAS_BROTLI
+    if (compression == "br") {
+      std::size_t size = BrotliEncoderMaxCompressedSize(data.size());
+      Bytes output(size);
+      if (!BrotliEncoderCompress(11, BROTLI_DEFAULT_WINDOW, BROTLI_DEFAULT_MODE, data.size(),
+                                 data.data(), &size, output.data())) {
+        return std::nullopt;
+      }
+      output.resize(size);
+      return output;
+    }
+#endif
+#ifdef DESKGUI_HAS_ZSTD
+    if (compression == "zstd") {
+      Bytes output(ZSTD_compressBound(data.size()));
+      const auto size = ZSTD_compress(output.data(), output.size(), data.data(), data.size(), 19);
+      if (ZSTD_isError(size)) return std::nullopt;
+      output.resize(size);
+      return output;
+    }
+#endif
+    throw std::runtime_error("deskgui_rc was built without " + compression + " support");
+  }
+
+  // Identifier of a resource built from its whole relative path, as
+  // resource_content.resource_identifier.
+  std::string identifier(const std::string& resourceFile) {
+    std::string name = resourceFile;
+    for (char& c : name) {
+      const bool word = (c >= '0' && c <= '9') || (c >= 'A' && c <= 'Z') || (c >= 'a' && c <= 'z')
+                        || c == '_';
+      if (!word) c = '_';
+    }
+    return name;
+  }
+
+  // Streams the bytes as the hex array of resource_content.generate_binary_array, twelve per
+  // line, without formatting each byte on its own.
+  void appendBinaryArray(std::string& cpp, const std::string& name, const Bytes& data) {
+    static const auto kHex = [] {
+      std::array<std::array<char, 4>, 256> table{};
+      static constexpr char kDigits[] = "0123456789ABCDEF";
+      for (std::size_t i = 0; i < 256; ++i) {
+        table[i] = {'0', 'x', kDigits[i >> 4], kDigits[i & 0xF]};
+      }
+      return table;
+    }();
+
+    cpp += "inline constexpr std::array<unsigned char, " + std::to_string(data.size()) + "> "
+           + name + " = {\n";
+    cpp.reserve(cpp.size() + data.size() * 6 + data.size() / 12 * 10 + 32);
+    cpp += "        ";
+    for (std::size_t i = 0; i < data.size(); ++i) {
+      if (i > 0) cpp += i % 12 == 0 ? ",\n        " : ", ";
+      cpp.append(kHex[data[i]].data(), 4);
+    }
+    cpp += "\n    };\n\n";
+  }
+
+  void appendIncbinArray(std::string& cpp, const std::string& name, const std::string& symbol,
+                         const std::filesystem::path& blob) {
+    // Normalized with forward slashes, as os.path.abspath of the Python generator writes it.
+    const auto path = std::filesystem::absolute(blob).lexically_normal().generic_string();
+    cpp += "extern \"C\" const unsigned char " + name + "[] __asm__(\"" + symbol + "\");\n\n";
+    cpp += "__asm__(\n";
+    cpp += "#if defined(__APPLE__)\n";
+    cpp += "    \".const_data\\n\"\n";
+    cpp += "    \".globl " + symbol + "\\n\"\n";
+    cpp += "    \".weak_definition " + symbol + "\\n\"\n";
+    cpp += "    \".private_extern " + symbol + "\\n\"\n";
+    cpp += "#elif defined(_WIN32)\n";
+    cpp += "    \".section .rdata$" + symbol + ",\\\"dr\\\"\\n\"\n";
+    cpp += "    \".linkonce discard\\n\"\n";
+    cpp += "    \".globl " + symbol + "\\n\"\n";
+    cpp += "#else\n";
+    cpp += "    \".section .rodata." + symbol + ",\\\"aG\\\",@progbits," + symbol
+           + ",comdat\\n\"\n";
+    cpp += "    \".globl " + symbol + "\\n\"\n";
+    cpp += "    \".hidden " + symbol + "\\n\"\n";
+    cpp += "#endif\n";
+    cpp += "    \".balign 16\\n\"\n";
+    cpp += "    \"" + symbol + ":\\n\"\n";
+    cpp += "    \".incbin \\\"" + path + "\\\"\\n\"\n";
+    cpp += "    \".byte 0\\n\"\n";
+    cpp += "    \".text\\n\");\n\n";
+  }
+
+  void generateResource(const Options& options, const std::string& resourceFile) {
+    const std::filesystem::path resourcePath(resourceFile);
+    const auto name = identifier(resourceFile);
+
+    auto data = readFile(resourcePath);
+    const auto hash = Sha256::hex32(data);
+
+    // Already compressed formats (images, fonts, media) do not shrink, those are stored as is.
+    std::string encoding;
+    if (!options.compression.empty()) {
+      auto compressed = compress(data, options.compression);
+      if (compressed && compressed->size() < data.size()) {
+        data = std::move(*compressed);
+        encoding = options.compression;
+      }
+    }
+
+    std::string cpp = "#include \"deskgui/resource_compiler.h\"\n\n";
+    cpp += "using namespace deskgui;\n\n";
+
+    // Identical bytes share their symbol, whichever pack or path they are embedded for.
+    const auto symbol = "deskgui_blob_" + Sha256::hex32(data);
+    const auto arrayName = name + "_resource";
+    std::string array;
+    if (options.embed == "incbin") {
+      const auto blob = options.outputDir / (options.packName + "_" + name + ".bin");
+      writeIfChanged(blob, {reinterpret_cast<const char*>(data.data()), data.size()});
+      appendIncbinArray(cpp, arrayName, symbol, blob);
+      array = arrayName;
+    } else {
+      appendBinaryArray(cpp, symbol, data);
+      array = symbol + ".data()";
+    }
+
+    const auto mime = deskgui::utils::mimeType(resourcePath.extension().string());
+    cpp += "extern const ResourceEntry deskgui_" + options.packName + "_" + name + "_entry = {\n";
+    cpp += "    \"" + resourceFile + "\", " + array + ", " + std::to_string(data.size()) + ", \""
+           + std::string(mime) + "\", \"" + encoding + "\", \"" + hash + "\"};\n";
+
+    writeIfChanged(options.outputDir / (options.packName + "_" + name + ".cpp"), cpp);
+  }
+
+  Options parseArguments(int argc, char** argv) {
+    Options options;
+    for (int i = 1; i < argc; ++i) {
+      const std::string_view argument = argv[i];
+      const auto value = [&]() -> std::string {
+        if (i + 1 >= argc) throw std::invalid_argument(std::string(argument) + " expects a value");
+        return argv[++i];
+      };
+      if (argument == "-o" || argument == "--output_dir") {
+        options.outputDir = value();
+      } else if (argument == "-p" || argument == "--pack_name") {
+        options.packName = value();
+      } else if (argument == "-c" || argument == "--compression") {
+        options.compression = value();
+      } else if (argument == "-e" || argument == "--embed") {
+        options.embed = value();
+      } else if (argument == "-j" || argument == "--jobs") {
+        options.threads = std::max(1, std::stoi(value()));
+      } else if (argument == "-f" || argument == "--resource_files") {
+        while (i + 1 < argc && argv[i + 1][0] != '-') options.resourceFiles.emplace_back(argv[++i]);
+      } else {
+        throw std::invalid_argument("unknown argument " + std::string(argument));
+      }
+    }
+
+    if (options.outputDir.empty()) throw std::invalid_argument("--output_dir is required");
+    if (options.packName.empty()) throw std::invalid_argument("--pack_name is required");
+    if (options.packName.find(' ') != std::string::npos) {
+      throw std::invalid_argument("pack_name should not contain blank spaces");
+    }
+    if (options.resourceFiles.empty()) throw std::invalid_argument("--resource_files is required");
+    if (!options.compression.empty() && options.compression != "gzip"
+        && options.compression != "br" && options.compression != "zstd") {
+      throw std::invalid_argument("unknown compression " + options.compression);
+    }
+    if (options.embed != "incbin" && options.embed != "hex") {
+      throw std::invalid_argument("unknown embed " + options.embed);
+    }
+    return options;
+  }
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  Options options;
+  try {
+    options = parseArguments(argc, argv);
+  } catch (const std::exception& error) {
+    std::fprintf(stderr, "deskgui_rc: %s\n", error.what());
+    return 2;
+  }
+
+  // Each worker takes the next resource until none is left.
+  std::atomic<std::size_t> next{0};
+  std::mutex errorMutex;
+  std::string firstError;
+  const auto work = [&]() {
+    for (auto index = next++; index < options.resourceFiles.size(); index = next++) {
+      try {
+        generateResource(options, options.resourceFiles[index]);
+      } catch (const std::exception& error) {
+        std::lock_guard<std::mutex> lock(errorMutex);
+        if (firstError.empty()) firstError = error.what();
+      }
+    }
+  };
+
+  const auto threads = std::min<std::size_t>(options.threads, options.resourceFiles.size());
+  std::vector<std::thread> workers;
+  for (std::size_t i = 1; i < threads; ++i) workers.emplace_back(work);
+  work();
+  for (auto& worker : workers) worker.join();
+
+  if (!firstError.empty()) {
+    std::fprintf(stderr, "deskgui_rc: %s\n", firstError.c_str());
+    return 1;
+  }
+  return 0;
+}
@@ -4,22 +4,62 @@
 
 import argparse
 import os
+from concurrent.futures import ProcessPoolExecutor
 
-from resource_content import generate_resource_cpp_file
+from resource_content import generate_resource_cpp_file, resource_entry_name
 from resource_library import generate_library_cpp
 
+def preload_paths(parser, args):
+    '''
+    Collect the paths to preload, the ones given first. A list holds a path per line, followed by
+    anything such as its hit count. Listed paths that are not packed are skipped: a list written
+    from the requests of a previous run also holds routes and misses.
+    '''
+    packed = set(args.resource_files)
+    for path in args.preload:
+        if path not in packed:
+            parser.error(f"--preload: {path} is not a resource of the pack")
+    preload = list(dict.fromkeys(args.preload))
+
+    if args.preload_list:
+        with open(args.preload_list, "r", encoding="utf-8") as preload_list:
+            for line in preload_list:
+                words = line.split("#", 1)[0].split()
+                if words and words[0] in packed and words[0] not in preload:
+                    preload.append(words[0])
+    return preload
+
 def main():
     parser = argparse.ArgumentParser(
         description="Generate C++ files for resource compiler"
     )
-    parser.add_argument("-o", "--output_dir", required=True, help="Output directory for generated files")
+    parser.add_argument(
+        "-m", "--mode", choices=["all", "library", "resources"], default="all",
+        help="Generate the library cpp, the resource files, or both"
+    )
+    parser.add_argument("-o", "--output_dir", help="Output directory for generated files")
     parser.add_argument("-p", "--pack_name", required=True, help="Name for the packed resource library")
     parser.add_argument(
-        "-r", "--resource_compiler_cpp", required=True, help="Path of the packed resource library cpp"
+        "-r", "--resource_compiler_cpp", help="Path of the packed resource library cpp"
     )
     parser.add_argument(
         "-f", "--resource_files", nargs="+", required=True, help="List of resource files to be packed"
     )
+    parser.add_argument(
+        "-c", "--compression", choices=["gzip", "br", "zstd"], help="Content-Encoding of the packed resources"
+    )
+    parser.add_argument(
+        "-e", "--embed", choices=["incbin", "hex"], default="hex", help="How resource bytes are embedded"
+    )
+    parser.add_argument(
+        "--minify", action="store_true", help="Minify JS, CSS, HTML and JSON and strip source maps"
+    )
+    parser.add_argument(
+        "--preload", nargs="*", default=[], help="Resources pages load first, in preload order"
+    )
+    parser.add_argument(
+        "--preload_list", help="File listing more resources to preload, a path per line"
+    )
 
     args = parser.parse_args()
 
@@ -28,11 +68,29 @@ def main():
         print("Error: pack_name should not contain blank spaces.")
         return
 
-    mount_methods = [
-        generate_resource_cpp_file(args.output_dir, args.pack_name, file)
-        for file in args.resource_files
-    ]
-    generate_library_cpp(args.pack_name, args.resource_compiler_cpp, mount_methods)
+    if args.mode != "library" and not args.output_dir:
+        parser.error("--output_dir is required to generate resource files")
+    if args.mode != "resources" and not args.resource_compiler_cpp:
+        parser.error("--resource_compiler_cpp is required to generate the library")
+
+    # The library only depends on the resource paths, the resource files on their content.
+    if args.mode != "library":
+        options = (args.compression, args.embed, args.minify)
+        if len(args.resource_files) == 1:
+            generate_resource_cpp_file(args.output_dir, args.pack_name, args.resource_files[0], *options)
+        else:
+            # Resources are independent, they are generated on every core.
+            with ProcessPoolExecutor() as executor:
+                futures = [
+                    executor.submit(generate_resource_cpp_file, args.output_dir, args.pack_name, file, *options)
+                    for file in args.resource_files
+                ]
+                for future in futures:
+                    future.result()
+    if args.mode != "resources":
+        entries = [(file, resource_entry_name(args.pack_name, file)) for file in args.resource_files]
+        preload = preload_paths(parser, args)
+        generate_library_cpp(args.pack_name, args.resource_compiler_cpp, entries, preload)
 
 
 if __name__ == "__main__":
@@ -30,6 +30,7 @@ MIME_TYPE_MAP = {
     ".ics": "text/calendar",
     ".jar": "application/java-archive",
     ".js": "application/javascript",
+    ".mjs": "application/javascript",
     ".json": "application/json",
     ".mid": "audio/midi",
     ".midi": "audio/midi",
@@ -67,4 +68,5 @@ MIME_TYPE_MAP = {
     ".3gp": "video/3gpp",
     ".3g2": "video/3gpp2",
     ".7z": "application/x-7z-compressed",
+    ".wasm": "application/wasm",
 }
@@ -0,0 +1,347 @@
+# deskgui - A powerful and flexible C++ library to create web-based desktop applications.
+# Copyright (c) 2023 deskgui
+# MIT License
+
+# Minification of the JS, CSS, HTML and JSON resources before they are packed. An installed
+# minifier (esbuild, terser, html-minifier-terser) is used when found on the PATH, the built-in
+# ones below otherwise. The built-in minifiers only drop comments and whitespace, they never
+# rename or rewrite code.
+
+import os
+import re
+import shutil
+import subprocess
+
+IDENTIFIER = re.compile(r"[A-Za-z0-9_$\\\u0080-\U0010ffff]")
+
+# Significant characters after which a "/" starts a regular expression rather than a division.
+REGEX_PREFIXES = set("(,=:[!&|?{};+-*%<>~^")
+REGEX_KEYWORDS = {
+    "return", "typeof", "instanceof", "in", "of", "new", "delete", "void", "throw", "case", "do",
+    "else", "yield", "await",
+}
+
+# A line break after or before these characters never ends a statement, it can be dropped.
+JOINS_AFTER = set("{;,([=:?&|*<>!~%^")
+JOINS_BEFORE = set("})],;:?")
+
+def is_identifier(char):
+    return bool(char) and IDENTIFIER.match(char) is not None
+
+def skip_string(text, i):
+    '''Returns the index after the string literal starting at i.'''
+    quote = text[i]
+    i += 1
+    while i < len(text) and text[i] != quote:
+        if text[i] == "\\":
+            i += 1
+        elif text[i] == "\n" and quote != "`":
+            break
+        i += 1
+    return i + 1
+
+def skip_template(text, i):
+    '''Returns the index after the template literal starting at i, with its ${} expressions.'''
+    i += 1
+    while i < len(text) and text[i] != "`":
+        if text[i] == "\\":
+            i += 2
+            continue
+        if text.startswith("${", i):
+            i = skip_code_block(text, i + 2)
+            continue
+        i += 1
+    return i + 1
+
+def skip_code_block(text, i):
+    '''Returns the index after the "}" closing the code starting at i.'''
+    depth = 1
+    while i < len(text) and depth:
+        char = text[i]
+        if char in "'\"":
+            i = skip_string(text, i)
+            continue
+        if char == "`":
+            i = skip_template(text, i)
+            continue
+        depth += 1 if char == "{" else -1 if char == "}" else 0
+        i += 1
+    return i
+
+def skip_regex(text, i):
+    '''Returns the index after the regular expression literal starting at i, with its flags.'''
+    i += 1
+    in_class = False
+    while i < len(text) and text[i] != "\n":
+        char = text[i]
+        if char == "\\":
+            i += 1
+        elif char == "[":
+            in_class = True
+        elif char == "]":
+            in_class = False
+        elif char == "/" and not in_class:
+            break
+        i += 1
+    i += 1
+    while i < len(text) and is_identifier(text[i]):
+        i += 1
+    return i
+
+def minify_js(text):
+    '''
+    Remove the comments and the whitespace of a script, keeping the line breaks that may end a
+    statement. Comments starting with "/*!" are kept, they usually hold a license.
+    '''
+    out = []
+    last = ""       # Last significant character written.
+    last_word = ""  # Last identifier written, to tell a regular expression from a division.
+    pending = ""    # Whitespace seen since the last token: "", " " or "\n".
+    i = 0
+
+    def emit(token):
+        nonlocal last, last_word, pending
+        first = token[0]
+        if pending == "\n" and last and last not in JOINS_AFTER and first not in JOINS_BEFORE:
+            out.append("\n")
+        elif pending and (
+            (is_identifier(last) and is_identifier(first))
+            or (last in "+-" and first == last)
+            or (last.isdigit() and first == ".")
+            or (last == "/" and first in "/*")
+        ):
+            out.append(" ")
+        out.append(token)
+        pending = ""
+        last = token[-1]
+        last_word = token if is_identifier(first) else ""
+
+    def postfix_operator():
+        # "++" or "--" written without a space in between ends an operand, "/" divides it.
+        return len(out) >= 2 and out[-1] == out[-2] and out[-1] in ("+", "-")
+
+    while i < len(text):
+        char = text[i]
+        if char in " \t\r\n\f\v\ufeff":
+            pending = "\n" if char == "\n" or pending == "\n" else " "
+            i += 1
+        elif text.startswith("//", i):
+            end = text.find("\n", i)
+            i = len(text) if end < 0 else end
+        elif text.startswith("/*", i):
+            end = text.find("*/", i + 2)
+            end = len(text) if end < 0 else end + 2
+            if text.startswith("/*!", i):
+                emit(text[i:end])
+            elif "\n" in text[i:end]:
+                pending = "\n"
+            elif not pending:
+                pending = " "
+            i = end
+        elif char in "'\"":
+            end = skip_string(text, i)
+            emit(text[i:end])
+            i = end
+        elif char == "`":
+            end = skip_template(text, i)
+            emit(text[i:end])
+            i = end
+        elif char == "/" and (not last or last in REGEX_PREFIXES or last_word in REGEX_KEYWORDS) \
+                and not postfix_operator():
+            end = skip_regex(text, i)
+            emit(text[i:end])
+            i = end
+        elif is_identifier(char):
+            end = i
+            while end < len(text) and is_identifier(text[end]):
+                end += 1
+            emit(text[i:end])
+            i = end
+        else:
+            emit(char)
+            i += 1
+    return "".join(out)
+
+def minify_css(text):
+    '''
+    Remove the comments and the whitespace of a style sheet. Comments starting with "/*!" are
+    kept. Spaces before ":" are kept, they separate a descendant selector from a pseudo-class.
+    '''
+    out = []
+    pending = False
+    i = 0
+
+    def emit(token):
+        nonlocal pending
+        if pending and out and out[-1][-1] not in "{};,>:" and token[0] not in "{};,>!":
+            out.append(" ")
+        if token == "}" and out and out[-1] == ";":
+            out.pop()
+        out.append(token)
+        pending = False
+
+    while i < len(text):
+        char = text[i]
+        if char.isspace():
+            pending = True
+            i += 1
+        elif text.startswith("/*", i):
+            end = text.find("*/", i + 2)
+            end = len(text) if end < 0 else end + 2
+            if text.startswith("/*!", i):
+                emit(text[i:end])
+            else:
+                pending = True
+            i = end
+        elif char in "'\"":
+            end = skip_string(text, i)
+            emit(text[i:end])
+            i = end
+        else:
+            emit(char)
+            i += 1
+    return "".join(out)
+
+def minify_json(text):
+    '''Remove the whitespace between the tokens of a JSON document.'''
+    out = []
+    i = 0
+    while i < len(text):
+        char = text[i]
+        if char == '"':
+            end = skip_string(text, i)
+            out.append(text[i:end])
+            i = end
+        else:
+            if not char.isspace():
+                out.append(char)
+            i += 1
+    return "".join(out)
+
+SCRIPT_TYPES = {"", "text/javascript", "application/javascript", "module"}
+JSON_SCRIPT_TYPES = {"application/json", "application/ld+json", "importmap"}
+RAW_ELEMENTS = re.compile(r"<(script|style|pre|textarea)\b([^>]*)>(.*?)</\1\s*>", re.I | re.S)
+TYPE_ATTRIBUTE = re.compile(r"""\btype\s*=\s*["']?([^"'\s>]*)""", re.I)
+
+def minify_html_text(text):
+    '''Drop comments and collapse whitespace, outside quoted attribute values.'''
+    out = []
+    i = 0
+    in_tag = False
+    while i < len(text):
+        char = text[i]
+        if not in_tag and text.startswith("<!--", i) and not text.startswith("<!--[", i):
+            end = text.find("-->", i + 4)
+            i = len(text) if end < 0 else end + 3
+        elif char.isspace():
+            end = i
+            while end < len(text) and text[end].isspace():
+                end += 1
+            if not (in_tag and text[end:end + 1] == ">") and not (out and out[-1] == " "):
+                out.append(" ")
+            i = end
+        elif in_tag and char in "'\"":
+            end = text.find(char, i + 1)
+            end = len(text) if end < 0 else end + 1
+            out.append(text[i:end])
+            i = end
+        else:
+            if char == "<" and text[i + 1:i + 2].isalpha() or text.startswith("</", i):
+                in_tag = True
+            elif char == ">":
+                in_tag = False
+            out.append(char)
+            i += 1
+    return "".join(out)
+
+def minify_html(text):
+    '''
+    Remove the comments and collapse the whitespace of a page. Scripts and styles are minified
+    with the built-in minifiers, <pre> and <textarea> contents are kept as is.
+    '''
+    out = []
+    position = 0
+    for element in RAW_ELEMENTS.finditer(text):
+        out.append(minify_html_text(text[position:element.start(3)]))
+        name, attributes, content = element.group(1).lower(), element.group(2), element.group(3)
+        script_type = TYPE_ATTRIBUTE.search(attributes)
+        script_type = script_type.group(1).lower() if script_type else ""
+        if name == "style":
+            content = minify_css(content)
+        elif name == "script" and script_type in SCRIPT_TYPES:
+            content = minify_js(content)
+        elif name == "script" and script_type in JSON_SCRIPT_TYPES:
+            content = minify_json(content)
+        out.append(content)
+        out.append(text[element.end(3):element.end()])
+        position = element.end()
+    out.append(minify_html_text(text[position:]))
+    return "".join(out).strip()
+
+SOURCE_MAP_COMMENT = re.compile(r"\n?(//[#@] sourceMappingURL=[^\n]*|/\*[#@] sourceMappingURL=.*?\*/)")
+
+def strip_source_map(text):
+    return SOURCE_MAP_COMMENT.sub("", text)
+
+# Extension: (built-in minifier, installed minifiers tried first as command lines reading stdin)
+MINIFIERS = {
+    ".js": (minify_js, [["esbuild", "--minify", "--loader=js"], ["terser", "--compress", "--mangle"]]),
+    ".mjs": (minify_js, [["esbuild", "--minify", "--loader=js"], ["terser", "--compress", "--mangle", "--module"]]),
+    ".css": (minify_css, [["esbuild", "--minify", "--loader=css"]]),
+    ".html": (minify_html, [["html-minifier-terser", "--collapse-whitespace", "--remove-comments", "--minify-css", "true", "--minify-js", "true"]]),
+    ".htm": (minify_html, [["html-minifier-terser", "--collapse-whitespace", "--remove-comments", "--minify-css", "true", "--minify-js", "true"]]),
+    ".json": (minify_json, []),
+}
+
+def run_minifier(command, text):
+    executable = shutil.which(command[0])
+    if not executable:
+        return None
+    try:
+        result = subprocess.run([executable] + command[1:], input=text.encode("utf-8"),
+                                capture_output=True, timeout=120)
+    except (OSError, subprocess.TimeoutExpired):
+        return None
+    if result.returncode != 0:
+        return None
+    return result.stdout.decode("utf-8")
+
+def minify_resource(resource_file_path, binary_data):
+    '''
+    Minify a resource if it is a script, a style sheet, a page or a JSON document, and report the
+    bytes saved. Other resources, and the ones that do not shrink, are returned as is.
+
+    Args:
+        resource_file_path (str): The path of the resource, its extension selects the minifier.
+        binary_data (bytes): The content of the resource.
+
+    Returns:
+        bytes: The content to pack.
+    '''
+    _, file_extension = os.path.splitext(resource_file_path)
+    minifier = MINIFIERS.get(file_extension.lower())
+    if not minifier:
+        return binary_data
+    try:
+        text = binary_data.decode("utf-8")
+    except UnicodeDecodeError:
+        return binary_data
+
+    built_in, commands = minifier
+    tool = "built-in"
+    minified = None
+    for command in commands:
+        minified = run_minifier(command, text)
+        if minified is not None:
+            tool = command[0]
+            break
+    if minified is None:
+        minified = built_in(text)
+    minified = strip_source_map(minified).encode("utf-8")
+
+    if len(minified) >= len(binary_data):
+        return binary_data
+    saved = len(binary_data) - len(minified)
+    print(f"Minified {resource_file_path} with {tool}: {len(binary_data)} -> {len(minified)} bytes, "
+          f"{saved} saved ({saved * 100 // len(binary_data)}%)")
+    return minified
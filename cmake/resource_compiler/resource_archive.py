@@ -0,0 +1,135 @@
+# deskgui - A powerful and flexible C++ library to create web-based desktop applications.
+# Copyright (c) 2023 deskgui
+# MIT License
+
+# Archive layout, read by loadResourceArchive (source/resource_archive.cpp). Integers are little
+# endian and offsets are relative to the start of the archive.
+#
+#   Header (32 bytes)  magic[8] "DSKGUIRA", u32 version, u32 count, u64 index, u64 strings
+#   Index              count entries of 48 bytes sorted by path:
+#                      u64 data, u64 size, u32 path, u32 pathSize, u32 mime, u32 mimeSize,
+#                      u32 encoding, u32 encodingSize, u32 hash, u32 hashSize (string offsets
+#                      relative to strings)
+#   Strings            UTF-8 paths, mime types, encodings and content hashes
+#   Blobs              resource bytes, each aligned to 16 bytes. Entries storing the same bytes
+#                      share one blob.
+#
+# An archive appended to another file is followed by a 16 bytes footer: u64 archive size and
+# the magic.
+
+import argparse
+import os
+import struct
+
+from mime_types import MIME_TYPE_MAP
+from resource_content import compress_binary_data, content_hash, get_binary_data_from_file
+
+ARCHIVE_MAGIC = b"DSKGUIRA"
+ARCHIVE_VERSION = 2
+HEADER_FORMAT = "<8sIIQQ"
+ENTRY_FORMAT = "<QQIIIIIIII"
+FOOTER_FORMAT = "<Q8s"
+BLOB_ALIGNMENT = 16
+APPEND_ALIGNMENT = 4096
+
+def align(offset, alignment):
+    return (offset + alignment - 1) // alignment * alignment
+
+def generate_archive(archive_path, resource_files, compression=None):
+    '''
+    Write the resource files to an archive.
+
+    Args:
+        archive_path (str): The path of the archive to write.
+        resource_files (list): The paths of the resources, relative to the working directory.
+            They are also the paths the resources are served at.
+        compression (str): Optional encoding of the stored bytes: "gzip", "br" or "zstd".
+    '''
+    resources = []
+    for resource_file in sorted(set(resource_files), key=lambda path: path.encode("utf-8")):
+        data = get_binary_data_from_file(resource_file)
+        resource_hash = content_hash(data)
+        encoding = ""
+        if compression:
+            compressed_data = compress_binary_data(data, compression)
+            if len(compressed_data) < len(data):
+                data = compressed_data
+                encoding = compression
+
+        _, file_extension = os.path.splitext(resource_file)
+        mime = MIME_TYPE_MAP.get(file_extension, "application/octet-stream")
+        resources.append((resource_file.replace("\\", "/"), mime, encoding, resource_hash, data))
+
+    strings = bytearray()
+    def add_string(value):
+        encoded = value.encode("utf-8")
+        offset = len(strings)
+        strings.extend(encoded)
+        return offset, len(encoded)
+
+    index_offset = struct.calcsize(HEADER_FORMAT)
+    strings_offset = index_offset + len(resources) * struct.calcsize(ENTRY_FORMAT)
+    fields = [
+        (add_string(path), add_string(mime), add_string(encoding), add_string(resource_hash))
+        for path, mime, encoding, resource_hash, _ in resources
+    ]
+
+    blobs = bytearray()
+    blobs_offset = align(strings_offset + len(strings), BLOB_ALIGNMENT)
+    blob_offsets = {}
+    index = bytearray()
+    for (path, mime, encoding, resource_hash), (*_, data) in zip(fields, resources):
+        if data not in blob_offsets:
+            blobs.extend(b"\0" * (align(len(blobs), BLOB_ALIGNMENT) - len(blobs)))
+            blob_offsets[data] = blobs_offset + len(blobs)
+            blobs.extend(data)
+        index.extend(struct.pack(ENTRY_FORMAT, blob_offsets[data], len(data), *path, *mime, *encoding, *resource_hash))
+
+    with open(archive_path, "wb") as archive:
+        archive.write(struct.pack(HEADER_FORMAT, ARCHIVE_MAGIC, ARCHIVE_VERSION, len(resources), index_offset, strings_offset))
+        archive.write(index)
+        archive.write(strings)
+        archive.write(b"\0" * (blobs_offset - strings_offset - len(strings)))
+        archive.write(blobs)
+
+def append_archive(target_path, archive_path):
+    '''
+    Append an archive to a file, usually an executable, so loadAppendedResourceArchive finds it.
+
+    The archive starts on a page boundary so its blobs keep their alignment once mapped.
+
+    Args:
+        target_path (str): The path of the file the archive is appended to.
+        archive_path (str): The path of the archive.
+    '''
+    archive = get_binary_data_from_file(archive_path)
+    with open(target_path, "ab") as target:
+        target.seek(0, os.SEEK_END)
+        target_size = target.tell()
+        target.write(b"\0" * (align(target_size, APPEND_ALIGNMENT) - target_size))
+        target.write(archive)
+        target.write(struct.pack(FOOTER_FORMAT, len(archive), ARCHIVE_MAGIC))
+
+def main():
+    parser = argparse.ArgumentParser(description="Generate a resource archive")
+    parser.add_argument("-o", "--output", required=True, help="Path of the generated archive")
+    parser.add_argument(
+        "-f", "--resource_files", nargs="+", help="List of resource files to be packed"
+    )
+    parser.add_argument(
+        "-c", "--compression", choices=["gzip", "br", "zstd"], help="Content-Encoding of the packed resources"
+    )
+    parser.add_argument("-a", "--append_to", help="Append the archive to this file instead")
+
+    args = parser.parse_args()
+
+    if args.append_to:
+        append_archive(args.append_to, args.output)
+    elif args.resource_files:
+        generate_archive(args.output, args.resource_files, args.compression)
+    else:
+        parser.error("either --resource_files or --append_to is required")
+
+
+if __name__ == "__main__":
+    main()
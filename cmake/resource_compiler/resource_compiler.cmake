@@ -5,20 +5,62 @@
 set(current_dir ${CMAKE_CURRENT_LIST_DIR})
 set(resource_compiler_build ${CMAKE_BINARY_DIR}/resource_compiler)
 
-# Define a CMake function to pack files into a resource library
+# Native generator of the resource sources, generate_resources.py is used instead when it cannot
+# run on the build machine (cross compiling) or for the options it does not implement (MINIFY, a
+# codec whose encoder library is missing).
+option(DESKGUI_RC_NATIVE "Generate compiled resources with the native deskgui_rc tool" ON)
+if(DESKGUI_RC_NATIVE AND NOT CMAKE_CROSSCOMPILING AND NOT TARGET deskgui_rc)
+    add_executable(deskgui_rc ${current_dir}/deskgui_rc.cpp)
+    set_target_properties(deskgui_rc PROPERTIES CXX_STANDARD 17 FOLDER "resources")
+    target_include_directories(deskgui_rc PRIVATE ${current_dir}/../../source)
+    find_package(Threads REQUIRED)
+    target_link_libraries(deskgui_rc PRIVATE Threads::Threads)
+
+    set(deskgui_rc_codecs "")
+    find_package(ZLIB QUIET)
+    if(ZLIB_FOUND)
+        target_link_libraries(deskgui_rc PRIVATE ZLIB::ZLIB)
+        target_compile_definitions(deskgui_rc PRIVATE DESKGUI_HAS_ZLIB)
+        list(APPEND deskgui_rc_codecs gzip)
+    endif()
+    find_package(PkgConfig QUIET)
+    if(PkgConfig_FOUND)
+        pkg_check_modules(brotlienc QUIET IMPORTED_TARGET libbrotlienc)
+        if(brotlienc_FOUND)
+            target_link_libraries(deskgui_rc PRIVATE PkgConfig::brotlienc)
+            target_compile_definitions(deskgui_rc PRIVATE DESKGUI_HAS_BROTLI)
+            list(APPEND deskgui_rc_codecs br)
+        endif()
+        pkg_check_modules(zstd QUIET IMPORTED_TARGET libzstd)
+        if(zstd_FOUND)
+            target_link_libraries(deskgui_rc PRIVATE PkgConfig::zstd)
+            target_compile_definitions(deskgui_rc PRIVATE DESKGUI_HAS_ZSTD)
+            list(APPEND deskgui_rc_codecs zstd)
+        endif()
+    endif()
+    set_property(GLOBAL PROPERTY deskgui_rc_codecs ${deskgui_rc_codecs})
+endif()
+
+# Define a CMake function to pack files into a resource library. Each resource is generated and
+# compiled by its own build rule, editing a resource only rebuilds its object.
+#
+# MINIFY ON minifies the JS, CSS, HTML and JSON resources and leaves out the source maps, with
+# esbuild, terser or html-minifier-terser when installed and built-in minifiers otherwise. MINIFY
+# RELEASE does so for every build type but Debug.
+#
+# PRELOAD lists the resources the pages load first, such as their scripts and styles, and
+# PRELOAD_LIST names a file with more of them, a path per line followed by anything else. Pages of
+# the pack are served with a <link rel="preload"> per resource, so the webview fetches them all at
+# once. The file can be written from Webview::resourceStats after a run, paths that are not packed
+# are skipped.
 macro(resource_compiler)
-    set(oneValueArgs TARGET_NAME PACK_NAME ROOT_FOLDER OBFUSCATE)
-    set(multiValueArgs RESOURCE_FILES)
+    set(oneValueArgs TARGET_NAME PACK_NAME ROOT_FOLDER OBFUSCATE COMPRESSION EMBED MINIFY
+        PRELOAD_LIST)
+    set(multiValueArgs RESOURCE_FILES PRELOAD)
     cmake_parse_arguments(ARG "${options}" "${oneValueArgs}" "${multiValueArgs}" ${ARGN})
 
     # Set build directory
     set(build_dir ${CMAKE_BINARY_DIR}/${ARG_PACK_NAME})
-
-    # Create the directory if it doesn't exist
-    if(EXISTS ${build_dir})
-        file(REMOVE_RECURSE ${build_dir})
-    endif()
-
     file(MAKE_DIRECTORY ${build_dir})
 
     # Set current directory and build directory
@@ -31,25 +73,123 @@ macro(resource_compiler)
     # Paths for resource compiler
     set(resource_compiler_cpp ${current_resource_compiler_build}/resource_compiler.cpp)
 
-    # Calculate the relative path from CMake script location to resources
+    # Optional Content-Encoding of the packed bytes, decoded by the webview when served
+    set(compression_args "")
+    if(ARG_COMPRESSION)
+        if(NOT ARG_COMPRESSION MATCHES "^(gzip|br|zstd)$")
+            message(FATAL_ERROR "resource_compiler: COMPRESSION must be gzip, br or zstd")
+        endif()
+        set(compression_args -c ${ARG_COMPRESSION})
+    endif()
+
+    # Assemble the bytes with .incbin where the toolchain allows it, so the compiler does not
+    # parse a hex literal per byte. MSVC has no inline assembly and uses the hex arrays.
+    if(NOT ARG_EMBED)
+        if(CMAKE_CXX_COMPILER_ID MATCHES "GNU|Clang" AND NOT MSVC)
+            set(ARG_EMBED incbin)
+        else()
+            set(ARG_EMBED hex)
+        endif()
+    elseif(NOT ARG_EMBED MATCHES "^(incbin|hex)$")
+        message(FATAL_ERROR "resource_compiler: EMBED must be incbin or hex")
+    endif()
+
+    # Multi-config generators share the generated files between configurations, RELEASE
+    # minifies them for all of them
+    set(minify_args "")
+    if(ARG_MINIFY STREQUAL "RELEASE")
+        if(CMAKE_CONFIGURATION_TYPES OR NOT CMAKE_BUILD_TYPE STREQUAL "Debug")
+            set(minify_args --minify)
+        endif()
+    elseif(ARG_MINIFY)
+        set(minify_args --minify)
+    endif()
+    if(minify_args)
+        list(FILTER ARG_RESOURCE_FILES EXCLUDE REGEX "\\.map$")
+    endif()
+
+    find_package(Python COMPONENTS Interpreter)
+
+    set(resource_generator_scripts
+        ${current_dir}/generate_resources.py
+        ${current_dir}/mime_types.py
+        ${current_dir}/minify.py
+        ${current_dir}/resource_content.py
+    )
+
+    get_property(deskgui_rc_codecs GLOBAL PROPERTY deskgui_rc_codecs)
+    if(TARGET deskgui_rc AND NOT minify_args
+       AND (NOT ARG_COMPRESSION OR ARG_COMPRESSION IN_LIST deskgui_rc_codecs))
+        set(resource_generator $<TARGET_FILE:deskgui_rc>)
+        set(resource_generator_depends deskgui_rc)
+    else()
+        set(resource_generator ${Python_EXECUTABLE} ${current_dir}/generate_resources.py -m resources)
+        set(resource_generator_depends ${resource_generator_scripts})
+    endif()
+
+    # One rule per resource, named after its relative path as generate_resource_cpp_file names
+    # its outputs
     set(RELATIVE_RESOURCES_FILES "")
+    set(resource_names "")
+    set(resources "")
 
     foreach(resource_file ${ARG_RESOURCE_FILES})
         get_filename_component(abs_path ${resource_file} ABSOLUTE)
         file(RELATIVE_PATH relative_path ${CMAKE_CURRENT_SOURCE_DIR}/${ARG_ROOT_FOLDER} ${abs_path})
         list(APPEND RELATIVE_RESOURCES_FILES ${relative_path})
+
+        string(REGEX REPLACE "[^0-9A-Za-z_]" "_" resource_name "${relative_path}")
+        if(resource_name IN_LIST resource_names)
+            message(FATAL_ERROR "resource_compiler: ${relative_path} has the same generated name "
+                                "(${resource_name}) as another resource of ${ARG_PACK_NAME}")
+        endif()
+        list(APPEND resource_names ${resource_name})
+        set(resource_cpp ${build_dir}/${ARG_PACK_NAME}_${resource_name}.cpp)
+        set(resource_outputs ${resource_cpp})
+        if(ARG_EMBED STREQUAL "incbin")
+            # Blobs are read by the assembler, rebuild their object when they change
+            set(resource_blob ${build_dir}/${ARG_PACK_NAME}_${resource_name}.bin)
+            list(APPEND resource_outputs ${resource_blob})
+            set_source_files_properties(${resource_cpp} PROPERTIES OBJECT_DEPENDS ${resource_blob})
+        endif()
+
+        # Outputs are only rewritten when their content changes, the stamp records the run
+        add_custom_command(
+            OUTPUT ${resource_cpp}.stamp
+            BYPRODUCTS ${resource_outputs}
+            COMMAND ${resource_generator} -o ${build_dir} -p ${ARG_PACK_NAME} -f ${relative_path} ${compression_args} -e ${ARG_EMBED} ${minify_args}
+            COMMAND ${CMAKE_COMMAND} -E touch ${resource_cpp}.stamp
+            WORKING_DIRECTORY ${CMAKE_CURRENT_SOURCE_DIR}/${ARG_ROOT_FOLDER}
+            DEPENDS ${abs_path} ${resource_generator_depends}
+            COMMENT "Compiling resource ${relative_path}"
+            VERBATIM
+        )
+        list(APPEND resources ${resource_cpp} ${resource_cpp}.stamp)
     endforeach()
 
-    find_package(Python COMPONENTS Interpreter)
+    # Preloaded paths are part of the registry, a change of the list reconfigures
+    set(preload_args "")
+    if(ARG_PRELOAD)
+        set(preload_args --preload ${ARG_PRELOAD})
+    endif()
+    if(ARG_PRELOAD_LIST)
+        get_filename_component(preload_list ${ARG_PRELOAD_LIST} ABSOLUTE)
+        list(APPEND preload_args --preload_list ${preload_list})
+        set_property(DIRECTORY APPEND PROPERTY CMAKE_CONFIGURE_DEPENDS ${preload_list})
+    endif()
 
-    # Call generate_resource.py script
+    # The registry only depends on the resource paths, it is written when configuring and left
+    # untouched while they stay the same
     execute_process(
-        COMMAND ${CMAKE_COMMAND} -E env ${Python_EXECUTABLE} ${current_dir}/generate_resources.py -o ${build_dir} -p ${ARG_PACK_NAME} -r ${resource_compiler_cpp} -f ${RELATIVE_RESOURCES_FILES}
+        COMMAND ${Python_EXECUTABLE} ${current_dir}/generate_resources.py -m library -p ${ARG_PACK_NAME} -r ${resource_compiler_cpp} -f ${RELATIVE_RESOURCES_FILES} ${preload_args}
         WORKING_DIRECTORY ${CMAKE_CURRENT_SOURCE_DIR}/${ARG_ROOT_FOLDER}
+        RESULT_VARIABLE registry_result
     )
+    if(NOT registry_result EQUAL 0)
+        message(FATAL_ERROR "resource_compiler: cannot generate the registry of ${ARG_PACK_NAME}")
+    endif()
 
     # Create a static library with the packed resources (.cpp)
-    file(GLOB_RECURSE resources CONFIGURE_DEPENDS ${build_dir}/*.cpp)
     add_library(${ARG_PACK_NAME} STATIC ${resources} ${resource_compiler_cpp})
     target_include_directories(${ARG_PACK_NAME} PRIVATE ${current_resource_compiler_build})
     target_include_directories(${ARG_PACK_NAME} PRIVATE ${current_dir}/../../include) # fix this include
@@ -72,3 +212,60 @@ function(clean_resources TARGET_NAME)
         file(REMOVE_RECURSE ${target_resource_compiler_dir})
     endif()
 endfunction()
+
+# Pack files into a resource archive loaded at runtime with loadResourceArchive(path). Unlike
+# resource_compiler(), the archive is rebuilt when a resource changes without relinking TARGET_NAME.
+# With APPEND_TO_TARGET ON the archive is appended to the TARGET_NAME executable instead, load it
+# with loadAppendedResourceArchive(). Appending invalidates code signatures, sign afterwards.
+function(resource_archive)
+    set(options APPEND_TO_TARGET)
+    set(oneValueArgs TARGET_NAME ARCHIVE_NAME ROOT_FOLDER COMPRESSION OUTPUT_DIRECTORY)
+    set(multiValueArgs RESOURCE_FILES)
+    cmake_parse_arguments(ARG "${options}" "${oneValueArgs}" "${multiValueArgs}" ${ARGN})
+
+    if(NOT ARG_OUTPUT_DIRECTORY)
+        set(ARG_OUTPUT_DIRECTORY ${CMAKE_CURRENT_BINARY_DIR})
+    endif()
+    set(archive ${ARG_OUTPUT_DIRECTORY}/${ARG_ARCHIVE_NAME}.pak)
+
+    set(compression_args "")
+    if(ARG_COMPRESSION)
+        if(NOT ARG_COMPRESSION MATCHES "^(gzip|br|zstd)$")
+            message(FATAL_ERROR "resource_archive: COMPRESSION must be gzip, br or zstd")
+        endif()
+        set(compression_args -c ${ARG_COMPRESSION})
+    endif()
+
+    set(absolute_files "")
+    set(relative_files "")
+    foreach(resource_file ${ARG_RESOURCE_FILES})
+        get_filename_component(abs_path ${resource_file} ABSOLUTE)
+        file(RELATIVE_PATH relative_path ${CMAKE_CURRENT_SOURCE_DIR}/${ARG_ROOT_FOLDER} ${abs_path})
+        list(APPEND absolute_files ${abs_path})
+        list(APPEND relative_files ${relative_path})
+    endforeach()
+
+    find_package(Python COMPONENTS Interpreter)
+
+    add_custom_command(
+        OUTPUT ${archive}
+        COMMAND ${Python_EXECUTABLE} ${current_dir}/resource_archive.py -o ${archive} -f ${relative_files} ${compression_args}
+        WORKING_DIRECTORY ${CMAKE_CURRENT_SOURCE_DIR}/${ARG_ROOT_FOLDER}
+        DEPENDS ${absolute_files} ${current_dir}/resource_archive.py
+        COMMENT "Packing resource archive ${ARG_ARCHIVE_NAME}"
+        VERBATIM
+    )
+    add_custom_target(${ARG_ARCHIVE_NAME} DEPENDS ${archive})
+    set_target_properties(${ARG_ARCHIVE_NAME} PROPERTIES FOLDER "resources")
+    add_dependencies(${ARG_TARGET_NAME} ${ARG_ARCHIVE_NAME})
+
+    if(ARG_APPEND_TO_TARGET)
+        # Relink when the archive changes, the linker output never contains a previous archive
+        set_property(TARGET ${ARG_TARGET_NAME} APPEND PROPERTY LINK_DEPENDS ${archive})
+        add_custom_command(
+            TARGET ${ARG_TARGET_NAME} POST_BUILD
+            COMMAND ${Python_EXECUTABLE} ${current_dir}/resource_archive.py -o ${archive} -a $<TARGET_FILE:${ARG_TARGET_NAME}>
+            VERBATIM
+        )
+    endif()
+endfunction()
@@ -2,19 +2,103 @@
 # Copyright (c) 2023 deskgui
 # MIT License
 
+import hashlib
 import os
+import re
 
 from mime_types import MIME_TYPE_MAP
+from minify import minify_resource
 
 # Resource creation
 def get_binary_data_from_file(file_path):
     with open(file_path, "rb") as f:
         return f.read()
 
+def write_if_changed(file_path, data):
+    '''
+    Write a generated file unless it already holds the same data. An untouched file keeps its
+    timestamp, so the build does not recompile what depends on it.
+
+    Args:
+        file_path (str): The path of the file.
+        data (str or bytes): The content of the file.
+    '''
+    if isinstance(data, str):
+        data = data.encode("utf-8")
+    if os.path.exists(file_path) and get_binary_data_from_file(file_path) == data:
+        return
+    with open(file_path, "wb") as f:
+        f.write(data)
+
+def content_hash(binary_data):
+    '''
+    Hash of the content of a resource, served as its ETag.
+
+    Args:
+        binary_data (bytes): The content, before compression.
+
+    Returns:
+        str: The first 128 bits of the SHA-256 of the content, in hex.
+    '''
+    return hashlib.sha256(binary_data).hexdigest()[:32]
+
+def blob_symbol(stored_data):
+    '''
+    Symbol of the stored bytes of a resource, shared by every resource storing the same bytes.
+
+    Packs embedding the same file (a vendor bundle, a font) define the same symbol, and the linker
+    keeps a single copy of the bytes.
+
+    Args:
+        stored_data (bytes): The bytes as embedded, after compression.
+
+    Returns:
+        str: The symbol name.
+    '''
+    return f"deskgui_blob_{hashlib.sha256(stored_data).hexdigest()[:32]}"
+
+def compress_binary_data(binary_data, compression):
+    '''
+    Compress the binary data with the given Content-Encoding.
+
+    Args:
+        binary_data (bytes): The binary data to compress.
+        compression (str): The encoding: "gzip", "br" or "zstd".
+
+    Returns:
+        bytes: The compressed data.
+    '''
+    if compression == "gzip":
+        import gzip
+        # A fixed mtime keeps the output reproducible.
+        return gzip.compress(binary_data, compresslevel=9, mtime=0)
+
+    if compression == "br":
+        try:
+            import brotli
+        except ImportError:
+            raise SystemExit("Error: COMPRESSION br requires the 'brotli' Python package.")
+        return brotli.compress(binary_data, quality=11)
+
+    if compression == "zstd":
+        try:
+            import zstandard
+        except ImportError:
+            raise SystemExit("Error: COMPRESSION zstd requires the 'zstandard' Python package.")
+        return zstandard.ZstdCompressor(level=19).compress(binary_data)
+
+    raise SystemExit(f"Error: unknown compression '{compression}', expected gzip, br or zstd.")
+
+# "0x00" to "0xFF", formatted once rather than per byte.
+HEX_BYTES = [f"0x{byte:02X}" for byte in range(256)]
+
 def generate_binary_array(name, binary_data):
     '''
     Generate an array representation of the binary data as a C-style.
 
+    The array is an inline variable, every translation unit defining the same name shares one
+    definition once linked.
+
     Args:
         name (str): The name of the array.
         binary_data (bytes): The binary data to convert.
@@ -22,47 +106,141 @@ def generate_binary_array(name, binary_data):
     Returns:
         str: A string representation of the binary data as a C-style array.
     '''
-    cpp_content = f"constexpr std::array<unsigned char, {len(binary_data)}> {name} = {{\n"
+    cpp_content = f"inline constexpr std::array<unsigned char, {len(binary_data)}> {name} = {{\n"
 
     # Group bytes into chunks of 12
-    byte_lines = [", ".join(f"0x{byte:02X}" for byte in binary_data[i:i+12]) for i in range(0, len(binary_data), 12)]
+    hex_bytes = [HEX_BYTES[byte] for byte in binary_data]
+    byte_lines = [", ".join(hex_bytes[i:i+12]) for i in range(0, len(hex_bytes), 12)]
     cpp_content += "        " + ",\n        ".join(byte_lines) + "\n"
     
     cpp_content += f"    }};\n\n"
     return cpp_content
 
-def generate_resource_cpp_content(pack_name: str, resource_file_path: str):
+def generate_incbin_array(name, symbol, blob_file_path):
+    '''
+    Generate a declaration of the binary data assembled into the object file with .incbin.
+
+    The assembler copies the blob file as is, so the compiler never parses the bytes. Supported
+    by GCC and Clang on ELF, Mach-O and COFF targets. The data is a COMDAT group (ELF, COFF) or a
+    weak definition (Mach-O), objects defining the same symbol share one copy once linked.
+
+    Args:
+        name (str): The name of the array.
+        symbol (str): The assembler symbol of the data, unique across packs.
+        blob_file_path (str): The path of the file holding the binary data.
+
+    Returns:
+        str: The declaration of the array and the assembly including the blob.
+    '''
+    blob_file_path = os.path.abspath(blob_file_path).replace("\\", "/")
+
+    # The asm label keeps the symbol name identical on every platform (no leading underscore).
+    cpp_content = f'extern "C" const unsigned char {name}[] __asm__("{symbol}");\n\n'
+    cpp_content += "__asm__(\n"
+    cpp_content += "#if defined(__APPLE__)\n"
+    cpp_content += '    ".const_data\\n"\n'
+    cpp_content += f'    ".globl {symbol}\\n"\n'
+    cpp_content += f'    ".weak_definition {symbol}\\n"\n'
+    cpp_content += f'    ".private_extern {symbol}\\n"\n'
+    cpp_content += "#elif defined(_WIN32)\n"
+    cpp_content += f'    ".section .rdata${symbol},\\"dr\\"\\n"\n'
+    cpp_content += '    ".linkonce discard\\n"\n'
+    cpp_content += f'    ".globl {symbol}\\n"\n'
+    cpp_content += "#else\n"
+    cpp_content += f'    ".section .rodata.{symbol},\\"aG\\",@progbits,{symbol},comdat\\n"\n'
+    cpp_content += f'    ".globl {symbol}\\n"\n'
+    cpp_content += f'    ".hidden {symbol}\\n"\n'
+    cpp_content += "#endif\n"
+    cpp_content += '    ".balign 16\\n"\n'
+    cpp_content += f'    "{symbol}:\\n"\n'
+    cpp_content += f'    ".incbin \\"{blob_file_path}\\"\\n"\n'
+    cpp_content += '    ".byte 0\\n"\n'
+    cpp_content += '    ".text\\n");\n\n'
+    return cpp_content
+
+def generate_resource_cpp_content(pack_name: str, resource_file_path: str, compression=None,
+                                  blob_file_path=None, minify=False):
     '''
     Generate the C++ content for a resource file.
 
     Args:
         pack_name (str): The name of the resource pack.
         resource_file_path (str): The path to the resource file.
+        compression (str): Optional encoding of the stored bytes: "gzip", "br" or "zstd".
+        blob_file_path (str): Optional path where the stored bytes are written to be embedded
+            with .incbin. The bytes are written as a hex array when not set.
+        minify (bool): Whether scripts, style sheets, pages and JSON documents are minified.
 
     Returns:
         str: The generated C++ content for the resource file.
     '''
-    resource_file_name, file_extension = os.path.splitext(
-        os.path.basename(resource_file_path)
-    )
+    _, file_extension = os.path.splitext(os.path.basename(resource_file_path))
     binary_data = get_binary_data_from_file(resource_file_path)
+    if minify:
+        binary_data = minify_resource(resource_file_path, binary_data)
+    resource_hash = content_hash(binary_data)
 
-    resource_data_name = resource_file_name.replace(".", "_").replace("-", "_")
-    resource_data_array_name = f"{resource_data_name}_resource"
+    # Already compressed formats (images, fonts, media) do not shrink, those are stored as is.
+    encoding = ""
+    if compression:
+        compressed_data = compress_binary_data(binary_data, compression)
+        if len(compressed_data) < len(binary_data):
+            binary_data = compressed_data
+            encoding = compression
+
+    resource_data_array_name = f"{resource_identifier(resource_file_path)}_resource"
 
     cpp_content = f'#include "deskgui/resource_compiler.h"\n\n'
     cpp_content += f"using namespace deskgui;\n\n"
     
-    cpp_content += generate_binary_array(resource_data_array_name, binary_data)
-
-    cpp_content += f"Resource mount_{pack_name}_{resource_data_name}() {{\n"
-    cpp_content += f'    std::vector<unsigned char> resource({resource_data_array_name}.begin(), {resource_data_array_name}.end());\n'
-    cpp_content += f'    return {{"{resource_file_path}", resource, "{MIME_TYPE_MAP.get(file_extension, "application/octet-stream")}"}};\n'
+    # Identical bytes share their symbol, whichever pack or path they are embedded for.
+    symbol = blob_symbol(binary_data)
+    if blob_file_path:
+        write_if_changed(blob_file_path, binary_data)
+        cpp_content += generate_incbin_array(resource_data_array_name, symbol, blob_file_path)
+        data = resource_data_array_name
+    else:
+        cpp_content += generate_binary_array(symbol, binary_data)
+        data = f"{symbol}.data()"
 
-    cpp_content += f"}}\n"
+    # Constant initialized, the registry refers to the entry and the array without copying them.
+    mime = MIME_TYPE_MAP.get(file_extension, "application/octet-stream")
+    cpp_content += f"extern const ResourceEntry {resource_entry_name(pack_name, resource_file_path)} = {{\n"
+    cpp_content += f'    "{resource_file_path}", {data}, {len(binary_data)}, "{mime}", "{encoding}", "{resource_hash}"}};\n'
     return cpp_content
 
-def generate_resource_cpp_file(output_dir, pack_name, resource_file):
+def resource_identifier(resource_file_path):
+    '''
+    Identifier of a resource file, naming its generated files and C++ symbols.
+
+    Built from the whole relative path, so files sharing a name in different folders
+    ("css/app.css", "js/app.js") or differing by their extension get different names. Every UTF-8
+    byte other than an ASCII letter, digit or "_" becomes "_", as resource_compiler.cmake and
+    deskgui_rc do.
+
+    Args:
+        resource_file_path (str): The path to the resource file, relative to the root folder.
+
+    Returns:
+        str: The identifier.
+    '''
+    return re.sub(rb"[^0-9A-Za-z_]", b"_", resource_file_path.encode("utf-8")).decode("ascii")
+
+def resource_entry_name(pack_name, resource_file_path):
+    '''
+    Name of the ResourceEntry of a resource file.
+
+    Args:
+        pack_name (str): The name of the resource pack.
+        resource_file_path (str): The path to the resource file.
+
+    Returns:
+        str: The C++ name of the entry.
+    '''
+    return f"deskgui_{pack_name}_{resource_identifier(resource_file_path)}_entry"
+
+def generate_resource_cpp_file(output_dir, pack_name, resource_file, compression=None, embed="hex",
+                               minify=False):
     '''
     Generate a C++ file containing the resource content.
 
@@ -70,17 +248,24 @@ def generate_resource_cpp_file(output_dir, pack_name, resource_file):
         output_dir (str): The directory where the C++ file will be generated.
         pack_name (str): The name of the resource pack.
         resource_file (str): The path to the resource file.
+        compression (str): Optional encoding of the stored bytes: "gzip", "br" or "zstd".
+        embed (str): How the bytes are embedded: "incbin" (assembler) or "hex" (C++ array).
+        minify (bool): Whether scripts, style sheets, pages and JSON documents are minified.
 
     Returns:
-        str: The C++ method name of the mounted resource.
+        tuple: The path of the resource and the C++ name of its entry.
 
     '''
-    cpp_content = generate_resource_cpp_content(pack_name, resource_file)
-
-    resource_file_name, _ = os.path.splitext(os.path.basename(resource_file))
-    cpp_file_name = f"{pack_name}_{resource_file_name}.cpp"
+    resource_name = resource_identifier(resource_file)
+    cpp_file_name = f"{pack_name}_{resource_name}.cpp"
     cpp_file_path = os.path.join(output_dir, cpp_file_name)
 
-    with open(cpp_file_path, "w") as cpp_file:
-        cpp_file.write(cpp_content)
-    return f'mount_{pack_name}_{resource_file_name.replace(".", "_").replace("-", "_")}'
+    blob_file_path = None
+    if embed == "incbin":
+        blob_file_path = os.path.join(output_dir, f"{pack_name}_{resource_name}.bin")
+
+    cpp_content = generate_resource_cpp_content(pack_name, resource_file, compression, blob_file_path,
+                                                minify)
+
+    write_if_changed(cpp_file_path, cpp_content)
+    return resource_file, resource_entry_name(pack_name, resource_file)
@@ -4,6 +4,8 @@
 
 import os
 
+from resource_content import write_if_changed
+
 def find_extern_resources_code(content, pack_name):
     '''
     Find the start and end positions of the extern resources code block for a specific package.
@@ -19,66 +21,80 @@ def find_extern_resources_code(content, pack_name):
         f"// End extern {pack_name} resources\n"
     )
 
-def find_add_resources_code(content, pack_name):
+def find_registry_resources_code(content, pack_name):
     '''
-    Finds the start and end indices of the previously defined resources for a given pack_name.
+    Finds the start and end indices of the previously defined registry for a given pack_name.
 
     Args:
         content (str): The content to search in.
         pack_name (str): The name of the resource pack.
 
     Returns:
-        tuple: A tuple containing the start and end indices of the previously defined resources.
+        tuple: A tuple containing the start and end indices of the previously defined registry.
     '''
-    return content.find(f"    // Start add {pack_name} resources\n"), content.find(
-        f"    // End add {pack_name} resources\n"
+    return content.find(f"    // Start registry {pack_name} resources\n"), content.find(
+        f"    // End registry {pack_name} resources\n"
     )
 
-def generate_extern_resources_code(pack_name, mount_methods):
+def generate_extern_resources_code(pack_name, entries):
     '''
-    Generates the code to declare external resources for a given resource pack.
+    Generates the code to declare external resource entries for a given resource pack.
 
     Args:
         pack_name (str): The name of the resource pack.
-        mount_methods (list): A list of mount methods for the resource pack.
+        entries (list): The (path, entry name) of every resource of the pack.
 
     Returns:
-        str: The generated code to declare external resources.
+        str: The generated code to declare external resource entries.
     '''
     content = f"// Start extern {pack_name} resources\n"
-    content += (
-        "\n".join([f"extern Resource {method}();" for method in mount_methods]) + "\n"
-    )
+    content += "".join([f"extern const ResourceEntry {entry};\n" for _, entry in entries])
     content += f"// End extern {pack_name} resources\n"
 
     return content
-def mount_compiled_resources(pack_name, mount_methods):
+
+def generate_registry_resources_code(pack_name, entries, preload=()):
     '''
-    This method adds the code to mount a package's resources.
+    This method adds the code returning the sorted registry of a package's resources.
 
     Args:
         pack_name (str): The name of the package.
-        mount_methods (list): A list of mount methods for the package's resources.
+        entries (list): The (path, entry name) of every resource of the package.
+        preload (list): The paths of the resources pages load first, in preload order.
 
     Returns:
-        str: The generated code to mount the package's resources.
+        str: The generated code returning the package's registry.
     '''
-    content = f"    // Start add {pack_name} resources\n"
+    # ResourceRegistry::find is a binary search comparing paths byte by byte.
+    sorted_entries = sorted(entries, key=lambda entry: entry[0].encode("utf-8"))
+
+    content = f"    // Start registry {pack_name} resources\n"
     content += f'    if(name == "{pack_name}") {{\n'
-    for method in mount_methods:
-        content += f"        resources.emplace_back({method}());\n"
+    content += f"        static const ResourceEntry* const entries[] = {{\n"
+    for _, entry in sorted_entries:
+        content += f"            &{entry},\n"
+    content += f"        }};\n"
+    if preload:
+        content += f"        static constexpr std::string_view preload[] = {{\n"
+        for path in preload:
+            content += f'            "{path}",\n'
+        content += f"        }};\n"
+        content += f"        return {{entries, {len(sorted_entries)}, preload, {len(preload)}}};\n"
+    else:
+        content += f"        return {{entries, {len(sorted_entries)}}};\n"
     content += f"    }}\n"
-    content += f"    // End add {pack_name} resources\n"
+    content += f"    // End registry {pack_name} resources\n"
     return content
 
 
-def create_library_cpp(pack_name, mount_methods):
+def create_library_cpp(pack_name, entries, preload=()):
     '''
     Creates a new cpp file to compile resource content.
 
     Args:
         pack_name (str): The name of the resource pack.
-        mount_methods (list): A list of mount methods.
+        entries (list): The (path, entry name) of every resource of the pack.
+        preload (list): The paths of the resources pages load first, in preload order.
 
     Returns:
         str: The content of the cpp file.
@@ -86,19 +102,24 @@ def create_library_cpp(pack_name, mount_methods):
     cpp_content = f'#include "deskgui/resource_compiler.h"\n\n'
     cpp_content += f"using namespace deskgui;\n\n"
 
-    cpp_content += generate_extern_resources_code(pack_name, mount_methods)
+    cpp_content += generate_extern_resources_code(pack_name, entries)
+
+    cpp_content += (
+        f"ResourceRegistry deskgui::getCompiledResourceRegistry(const std::string& name) {{\n"
+    )
+    cpp_content += generate_registry_resources_code(pack_name, entries, preload)
+    cpp_content += f"    return {{}};\n"
+    cpp_content += f"}}\n\n"
 
     cpp_content += (
         f"Resources deskgui::getCompiledResources(const std::string& name) {{\n"
     )
-    cpp_content += f"    Resources resources;\n"
-    cpp_content += mount_compiled_resources(pack_name, mount_methods)
-    cpp_content += f"    return resources;\n"
+    cpp_content += f"    return getCompiledResourceRegistry(name).resources();\n"
     cpp_content += f"}}\n"
 
     return cpp_content
 
-def extend_library_cpp(existing_content, pack_name, mount_methods):
+def extend_library_cpp(existing_content, pack_name, entries, preload=()):
     '''
     Extends the library cpp file in case there is another package already defined.
     This is needed since we can mount multiple packages in the same library.
@@ -106,54 +127,47 @@ def extend_library_cpp(existing_content, pack_name, mount_methods):
     Args:
         existing_content (str): The existing content of the library cpp file.
         pack_name (str): The name of the package to be extended.
-        mount_methods (list): A list of mount methods for the package.
+        entries (list): The (path, entry name) of every resource of the package.
+        preload (list): The paths of the resources pages load first, in preload order.
 
     Returns:
         str: The updated content of the library cpp file after extending the package.
     '''
-    extern_start, extern_end = find_extern_resources_code(existing_content, pack_name)
+    new_content = existing_content
 
+    extern_start, extern_end = find_extern_resources_code(new_content, pack_name)
     if extern_start != -1 and extern_end != -1:
-        new_content = existing_content[:extern_start]
-        new_content += generate_extern_resources_code(pack_name, mount_methods)
-        new_content += existing_content[
-            extern_end + len(f"// End extern {pack_name} resources\n") :
-        ]
-
-        resources_start, resources_end = find_add_resources_code(new_content, pack_name)
-        if resources_start != -1 and resources_end != -1:
-            content = new_content
-            new_content = content[:resources_start]
-            new_content += mount_compiled_resources(pack_name, mount_methods)
-            new_content += content[
-                resources_end + len(f"    // End add {pack_name} resources\n") :
-            ]
+        extern_end += len(f"// End extern {pack_name} resources\n")
+    else:
+        extern_start = extern_end = new_content.find("ResourceRegistry deskgui::")
+    new_content = (
+        new_content[:extern_start]
+        + generate_extern_resources_code(pack_name, entries)
+        + new_content[extern_end:]
+    )
+
+    registry_start, registry_end = find_registry_resources_code(new_content, pack_name)
+    if registry_start != -1 and registry_end != -1:
+        registry_end += len(f"    // End registry {pack_name} resources\n")
     else:
-        start_marker = f"using namespace deskgui;\n\n"
-        end_marker = "    return resources;"
-        start_position = existing_content.find(start_marker)
-        end_position = existing_content.find(end_marker)
-
-        if start_position != -1 and end_position != -1:
-            new_content = existing_content[: start_position + len(start_marker)]
-            new_content += generate_extern_resources_code(pack_name, mount_methods)
-            new_content += existing_content[
-                start_position + len(start_marker) : end_position
-            ]
-            new_content += mount_compiled_resources(pack_name, mount_methods)
-            new_content += existing_content[end_position:]
-
-    # If no modification is made, return the original content
+        registry_start = registry_end = new_content.find("    return {};")
+    new_content = (
+        new_content[:registry_start]
+        + generate_registry_resources_code(pack_name, entries, preload)
+        + new_content[registry_end:]
+    )
+
     return new_content
 
-def generate_library_cpp(pack_name, resource_compiler_cpp, mount_methods):
+def generate_library_cpp(pack_name, resource_compiler_cpp, entries, preload=()):
     '''
     Generate the API C++ code for mounting different resource packages, allowing them to be accessed from a C++ executable. This code serves as the access point to the resources.
 
     Args:
         pack_name (str): The name of the resource package.
         resource_compiler_cpp (str): The path to the resource compiler C++ file.
-        mount_methods (list): A list of mount methods.
+        entries (list): The (path, entry name) of every resource of the package.
+        preload (list): The paths of the resources pages load first, in preload order.
 
     Returns:
         str: The generated API C++ code.
@@ -161,13 +175,16 @@ def generate_library_cpp(pack_name, resource_compiler_cpp, mount_methods):
     Raises:
         FileNotFoundError: If the resource compiler C++ file does not exist.
     '''
+    existing_content = None
     if os.path.exists(resource_compiler_cpp):
         with open(resource_compiler_cpp, "r") as cpp_file:
             existing_content = cpp_file.read()
 
-        cpp_content = extend_library_cpp(existing_content, pack_name, mount_methods)
+    # Files generated before the registry existed are recreated, every pack of the target is
+    # registered again on each configure.
+    if existing_content and "getCompiledResourceRegistry" in existing_content:
+        cpp_content = extend_library_cpp(existing_content, pack_name, entries, preload)
     else:
-        cpp_content = create_library_cpp(pack_name, mount_methods)
+        cpp_content = create_library_cpp(pack_name, entries, preload)
 
-    with open(resource_compiler_cpp, "w") as cpp_file:
-        cpp_file.write(cpp_content)
+    write_if_changed(resource_compiler_cpp, cpp_content)
@@ -27,7 +27,7 @@ int main() {
 
   auto webview = window->createWebview("webview", options);
     
-  webview->loadResources(getCompiledResources("web_resources"));
+  webview->loadResources(getCompiledResourceRegistry("web_resources"));
   webview->serveResource("index.html");
 
   // webview->serveResource("src/lenna.png"); //try loading a png!
@@ -67,6 +67,43 @@ namespace deskgui {
      */
     Window* getWindow(const std::string& name) const;
 
+    /**
+     * Keep webviews created in advance, so Window::createWebview hands one out instead of
+     * building a webview and, for the first one, starting a web process.
+     *
+     * The webviews live in hidden windows with the bridge script injected and the resources
+     * loaded. createWebview takes a ready one when it is called with the same options and moves
+     * it to its window, and builds a new webview while none is ready. The pool is refilled on the
+     * main thread, one webview per iteration of the event loop, so the loop keeps handling events
+     * meanwhile. WebView2 gets its webviews ready asynchronously, the next one is created once
+     * the last one is ready.
+     *
+     * @param size The number of webviews to keep, 0 destroys them.
+     * @param options The options the webviews are created with.
+     * @param resources The resources the webviews serve, loaded with Webview::loadResources.
+     */
+    void setWebviewPool(std::size_t size, const WebviewOptions& options = {},
+                        std::shared_ptr<const ResourcePack> resources = nullptr);
+
+    /**
+     * @brief Gets the number of webviews the pool holds ready to be handed out right now.
+     */
+    [[nodiscard]] std::size_t pooledWebviewCount() const;
+
+    /**
+     * @brief Hands a pooled webview over to a window, called by Window::createWebview.
+     *
+     * The webview leaves its hidden window for the given one and the pool is refilled.
+     *
+     * @param name The name given to the webview.
+     * @param window The content view of the window the webview is moved to.
+     * @param options The options the webview must have been created with.
+     * @return The webview, or nullptr when the pool is empty, holds no ready webview or was
+     * created with other options.
+     */
+    std::shared_ptr<Webview> takePooledWebview(const std::string& name, void* window,
+                                               const WebviewOptions& options) override;
+
     /**
      * @brief Gets the name of the application.
      *
@@ -16,6 +16,9 @@
 #include <type_traits>
 
 namespace deskgui {
+  class Webview;
+  class WebviewOptions;
+
   using DispatchTask = std::function<void()>;
 
   class AppHandler {
@@ -30,6 +33,17 @@ namespace deskgui {
      */
     virtual void destroyWindow(const std::string& name) = 0;
 
+    /**
+     * @brief Takes a webview the application created in advance, see App::setWebviewPool.
+     *
+     * @param name The name given to the webview.
+     * @param window The content view of the window the webview is moved to.
+     * @param options The options the webview must have been created with.
+     * @return The webview, moved to the window, or nullptr if none is ready with these options.
+     */
+    virtual std::shared_ptr<Webview> takePooledWebview(const std::string& name, void* window,
+                                                       const WebviewOptions& options) = 0;
+
     /**
      * @brief Checks if the current thread is the main thread.
      *
@@ -75,6 +89,16 @@ namespace deskgui {
       return future.get();
     };
 
+    /**
+     * @brief Posts a task to the main thread's message loop without waiting for it to run.
+     *
+     * Unlike dispatchOnMainThread, this method returns immediately, so it is safe to call from
+     * background threads that must not block on the main thread.
+     *
+     * @param task The task function to be posted.
+     */
+    void postOnMainThread(DispatchTask&& task) const { dispatch(std::move(task)); }
+
   protected:
     /**
      * @brief Posts a task to the main thread's message loop
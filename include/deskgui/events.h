@@ -9,6 +9,7 @@
 
 #include <deskgui/types.h>
 
+#include <chrono>
 #include <iostream>
 #include <string>
 
@@ -155,4 +156,17 @@ namespace deskgui::event {
     const std::string url;  // The URL of the window requested to be opened.
   };
 
+  /**
+   * @brief Represents a request to the custom scheme that took long to answer.
+   *
+   * Fired on the main thread when the response of a request is handed to the webview later than
+   * WebviewOptions::kSlowResourceThreshold after the request arrived.
+   */
+  struct WebviewSlowResource : Event {
+    WebviewSlowResource(const std::string& urlArg, std::chrono::microseconds latencyArg)
+        : Event(false), url(urlArg), latency(latencyArg) {}
+    const std::string url;                    // The URL requested by the page.
+    const std::chrono::microseconds latency;  // Time until the response.
+  };
+
 }  // namespace deskgui::event
@@ -0,0 +1,408 @@
+/**
+ * deskgui - A powerful and flexible C++ library to create web-based desktop applications.
+ *
+ * Copyright (c) 2023 deskgui
+ * MIT License
+ */
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <map>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace deskgui::json {
+
+  /**
+   * @brief Kind of a token produced by a TokenReader.
+   */
+  enum class TokenType {
+    kNull,
+    kBool,
+    kInt,     // Signed integer, stored in Token::integer.
+    kUint,    // Unsigned integer, stored in Token::unsignedInteger.
+    kDouble,  // Floating point number, stored in Token::number.
+    kString,
+    kKey,  // Object member name.
+    kStartObject,
+    kEndObject,
+    kStartArray,
+    kEndArray
+  };
+
+  /**
+   * @brief A single SAX event of a JSON document.
+   *
+   * The string view of kString and kKey tokens is only valid until the next call to
+   * TokenReader::next().
+   */
+  struct Token {
+    TokenType type = TokenType::kNull;
+    bool boolean = false;
+    std::int64_t integer = 0;
+    std::uint64_t unsignedInteger = 0;
+    double number = 0.0;
+    std::string_view string;
+  };
+
+  /**
+   * @brief Pull interface over a streaming (SAX) JSON parser.
+   *
+   * Values are deserialized straight from the token stream, without building an intermediate
+   * document.
+   */
+  class TokenReader {
+  public:
+    virtual ~TokenReader() = default;
+
+    /**
+     * @brief Advances to the next token.
+     *
+     * @param token Receives the next token.
+     * @return false at the end of the input or on a parse error.
+     */
+    virtual bool next(Token& token) = 0;
+  };
+
+  /**
+   * @brief A callback call bound to its deserialized arguments.
+   */
+  using Invocation = std::function<void()>;
+
+  /**
+   * @brief Consumes the value that starts with the given token.
+   *
+   * Used to deliver typed callback payloads: the reader is positioned on the first token of the
+   * value and the binding must consume exactly that value. Decoding and invoking are split so the
+   * payload can be parsed on one thread and the callback run on another.
+   *
+   * @return The call to run with the decoded value, or an empty function if the value does not
+   * match.
+   */
+  using Binding = std::function<Invocation(TokenReader& reader, const Token& first)>;
+
+  /**
+   * @brief Parses the JSON text and hands its token stream to the consumer.
+   *
+   * @param text The JSON text.
+   * @param consumer Reads as many tokens as it needs from the stream.
+   * @return The result of the consumer, or false if the text is not a single valid JSON value,
+   * even past the tokens the consumer read.
+   */
+  bool parse(std::string_view text, const std::function<bool(TokenReader&)>& consumer);
+
+  /**
+   * @brief Serializes the value that starts with the given token as compact JSON text.
+   *
+   * @param reader The token stream, positioned on the first token of the value.
+   * @param first The first token of the value.
+   * @param output Receives the JSON text.
+   * @return false if the token stream ends before the value is complete.
+   */
+  bool capture(TokenReader& reader, const Token& first, std::string& output);
+
+  /**
+   * @brief Keeps a value as raw JSON text instead of deserializing it.
+   */
+  struct RawJson {
+    std::string text;
+  };
+
+  /**
+   * @brief Describes a reflected member: its JSON name and its pointer-to-member.
+   */
+  template <typename Class, typename Member> struct Field {
+    std::string_view name;
+    Member Class::*pointer;
+  };
+
+  template <typename Class, typename Member>
+  constexpr Field<Class, Member> field(std::string_view name, Member Class::*pointer) {
+    return {name, pointer};
+  }
+
+  namespace detail {
+    // A type is reflected when DESKGUI_REFLECT declared deskguiFields() for it (found by ADL).
+    template <typename T, typename = void> struct IsReflected : std::false_type {};
+    template <typename T>
+    struct IsReflected<T, std::void_t<decltype(deskguiFields(static_cast<const T*>(nullptr)))>>
+        : std::true_type {};
+
+    template <typename T> struct IsVector : std::false_type {};
+    template <typename T, typename Allocator>
+    struct IsVector<std::vector<T, Allocator>> : std::true_type {};
+
+    template <typename T> struct IsArray : std::false_type {};
+    template <typename T, std::size_t N> struct IsArray<std::array<T, N>> : std::true_type {};
+
+    template <typename T> struct IsOptional : std::false_type {};
+    template <typename T> struct IsOptional<std::optional<T>> : std::true_type {};
+
+    template <typename T> struct IsTuple : std::false_type {};
+    template <typename... Ts> struct IsTuple<std::tuple<Ts...>> : std::true_type {};
+
+    template <typename T> struct IsStringMap : std::false_type {};
+    template <typename T, typename... Rest>
+    struct IsStringMap<std::map<std::string, T, Rest...>> : std::true_type {};
+    template <typename T, typename... Rest>
+    struct IsStringMap<std::unordered_map<std::string, T, Rest...>> : std::true_type {};
+  }  // namespace detail
+
+  /**
+   * @brief Skips the value that starts with the given token.
+   */
+  inline bool skip(TokenReader& reader, const Token& first) {
+    if (first.type != TokenType::kStartObject && first.type != TokenType::kStartArray) {
+      return first.type != TokenType::kKey && first.type != TokenType::kEndObject
+             && first.type != TokenType::kEndArray;
+    }
+    std::size_t depth = 1;
+    Token token;
+    while (depth > 0 && reader.next(token)) {
+      if (token.type == TokenType::kStartObject || token.type == TokenType::kStartArray) {
+        ++depth;
+      } else if (token.type == TokenType::kEndObject || token.type == TokenType::kEndArray) {
+        --depth;
+      }
+    }
+    return depth == 0;
+  }
+
+  /**
+   * @brief Deserializes the value that starts with the given token into the output.
+   *
+   * Supported types are bool, arithmetic types, std::string, RawJson, std::optional,
+   * std::vector, std::array, std::tuple (from a JSON array), string keyed maps and types
+   * described with DESKGUI_REFLECT. Object members that are missing keep their current value and
+   * unknown members are skipped.
+   *
+   * @return false if the JSON value does not match the type.
+   */
+  template <typename T> bool read(TokenReader& reader, const Token& first, T& output) {
+    if constexpr (std::is_same_v<T, bool>) {
+      if (first.type != TokenType::kBool) return false;
+      output = first.boolean;
+      return true;
+    } else if constexpr (std::is_integral_v<T>) {
+      using Limits = std::numeric_limits<T>;
+      if (first.type == TokenType::kInt) {
+        if constexpr (std::is_signed_v<T>) {
+          if (first.integer < static_cast<std::int64_t>(Limits::min())
+              || first.integer > static_cast<std::int64_t>(Limits::max())) {
+            return false;
+          }
+        } else {
+          if (first.integer < 0
+              || static_cast<std::uint64_t>(first.integer)
+                     > static_cast<std::uint64_t>(Limits::max())) {
+            return false;
+          }
+        }
+        output = static_cast<T>(first.integer);
+        return true;
+      }
+      if (first.type == TokenType::kUint) {
+        if (first.unsignedInteger > static_cast<std::uint64_t>(Limits::max())) return false;
+        output = static_cast<T>(first.unsignedInteger);
+        return true;
+      }
+      return false;
+    } else if constexpr (std::is_floating_point_v<T>) {
+      switch (first.type) {
+        case TokenType::kInt:
+          output = static_cast<T>(first.integer);
+          return true;
+        case TokenType::kUint:
+          output = static_cast<T>(first.unsignedInteger);
+          return true;
+        case TokenType::kDouble:
+          output = static_cast<T>(first.number);
+          return true;
+        default:
+          return false;
+      }
+    } else if constexpr (std::is_same_v<T, std::string>) {
+      if (first.type != TokenType::kString) return false;
+      output.assign(first.string);
+      return true;
+    } else if constexpr (std::is_same_v<T, RawJson>) {
+      return capture(reader, first, output.text);
+    } else if constexpr (detail::IsOptional<T>::value) {
+      if (first.type == TokenType::kNull) {
+        output.reset();
+        return true;
+      }
+      return read(reader, first, output.emplace());
+    } else if constexpr (detail::IsVector<T>::value) {
+      if (first.type != TokenType::kStartArray) return false;
+      output.clear();
+      Token token;
+      while (reader.next(token)) {
+        if (token.type == TokenType::kEndArray) return true;
+        typename T::value_type element{};
+        if (!read(reader, token, element)) return false;
+        output.push_back(std::move(element));
+      }
+      return false;
+    } else if constexpr (detail::IsArray<T>::value) {
+      if (first.type != TokenType::kStartArray) return false;
+      std::size_t index = 0;
+      Token token;
+      while (reader.next(token)) {
+        if (token.type == TokenType::kEndArray) return true;
+        if (index < output.size()) {
+          if (!read(reader, token, output[index++])) return false;
+        } else if (!skip(reader, token)) {
+          return false;
+        }
+      }
+      return false;
+    } else if constexpr (detail::IsTuple<T>::value) {
+      // Missing trailing elements keep their value and extra elements are ignored, so JavaScript
+      // callers may omit optional arguments.
+      if (first.type != TokenType::kStartArray) return false;
+      Token token;
+      bool ended = false;
+      bool valid = true;
+      std::apply(
+          [&](auto&... elements) {
+            ((valid = valid && !ended && reader.next(token)
+                      && ((token.type == TokenType::kEndArray && (ended = true))
+                          || read(reader, token, elements))),
+             ...);
+          },
+          output);
+      if (!valid) return ended;
+      while (!ended && reader.next(token)) {
+        if (token.type == TokenType::kEndArray) return true;
+        if (!skip(reader, token)) return false;
+      }
+      return ended;
+    } else if constexpr (detail::IsStringMap<T>::value) {
+      if (first.type != TokenType::kStartObject) return false;
+      output.clear();
+      Token token;
+      while (reader.next(token)) {
+        if (token.type == TokenType::kEndObject) return true;
+        std::string key{token.string};
+        if (!reader.next(token) || !read(reader, token, output[key])) return false;
+      }
+      return false;
+    } else if constexpr (detail::IsReflected<T>::value) {
+      if (first.type != TokenType::kStartObject) return false;
+      constexpr auto kNoMember = std::numeric_limits<std::size_t>::max();
+      const auto fields = deskguiFields(static_cast<const T*>(nullptr));
+      Token token;
+      while (reader.next(token)) {
+        if (token.type == TokenType::kEndObject) return true;
+        // Match the member name before advancing, the key view is invalidated by next().
+        std::size_t member = kNoMember;
+        std::apply(
+            [&](const auto&... members) {
+              std::size_t index = 0;
+              ((member == kNoMember && members.name == token.string ? void(member = index)
+                                                                    : void(),
+                ++index),
+               ...);
+            },
+            fields);
+        if (!reader.next(token)) return false;
+        bool valid = true;
+        std::apply(
+            [&](const auto&... members) {
+              std::size_t index = 0;
+              ((index++ == member ? void(valid = read(reader, token, output.*(members.pointer)))
+                                  : void()),
+               ...);
+            },
+            fields);
+        if (!valid || (member == kNoMember && !skip(reader, token))) return false;
+      }
+      return false;
+    } else {
+      static_assert(!sizeof(T), "Type cannot be deserialized, describe it with DESKGUI_REFLECT");
+    }
+  }
+
+  /**
+   * @brief Reads the next value of the token stream into the output.
+   */
+  template <typename T> bool read(TokenReader& reader, T& output) {
+    Token token;
+    return reader.next(token) && read(reader, token, output);
+  }
+
+  /**
+   * @brief Deserializes a JSON text into the output.
+   */
+  template <typename T> bool parse(std::string_view text, T& output) {
+    return parse(text, [&output](TokenReader& reader) { return read(reader, output); });
+  }
+
+  /**
+   * @brief Creates a binding that deserializes a JSON array into Args... and invokes the callback.
+   */
+  template <typename... Args, typename Callable> Binding bind(Callable&& callback) {
+    // Shared so that a pending invocation outlives the removal of its callback.
+    auto shared = std::make_shared<std::decay_t<Callable>>(std::forward<Callable>(callback));
+    return [shared](TokenReader& reader, const Token& first) -> Invocation {
+      std::tuple<std::decay_t<Args>...> arguments;
+      if (!read(reader, first, arguments)) return {};
+      return [shared, arguments = std::move(arguments)]() mutable {
+        std::apply(*shared, std::move(arguments));
+      };
+    };
+  }
+
+}  // namespace deskgui::json
+
+// Reflection-lite: describes the members of a type so it can be deserialized from JSON.
+// Must be used in the namespace that declares the type, for example:
+//
+//   struct Point { int x; int y; };
+//   DESKGUI_REFLECT(Point, x, y)
+//
+#define DESKGUI_JSON_EXPAND(x) x
+#define DESKGUI_JSON_FIELD(Type, member) ::deskgui::json::field(#member, &Type::member)
+#define DESKGUI_JSON_FE_1(M, T, x) M(T, x)
+#define DESKGUI_JSON_FE_2(M, T, x, ...) M(T, x), DESKGUI_JSON_EXPAND(DESKGUI_JSON_FE_1(M, T, __VA_ARGS__))
+#define DESKGUI_JSON_FE_3(M, T, x, ...) M(T, x), DESKGUI_JSON_EXPAND(DESKGUI_JSON_FE_2(M, T, __VA_ARGS__))
+#define DESKGUI_JSON_FE_4(M, T, x, ...) M(T, x), DESKGUI_JSON_EXPAND(DESKGUI_JSON_FE_3(M, T, __VA_ARGS__))
+#define DESKGUI_JSON_FE_5(M, T, x, ...) M(T, x), DESKGUI_JSON_EXPAND(DESKGUI_JSON_FE_4(M, T, __VA_ARGS__))
+#define DESKGUI_JSON_FE_6(M, T, x, ...) M(T, x), DESKGUI_JSON_EXPAND(DESKGUI_JSON_FE_5(M, T, __VA_ARGS__))
+#define DESKGUI_JSON_FE_7(M, T, x, ...) M(T, x), DESKGUI_JSON_EXPAND(DESKGUI_JSON_FE_6(M, T, __VA_ARGS__))
+#define DESKGUI_JSON_FE_8(M, T, x, ...) M(T, x), DESKGUI_JSON_EXPAND(DESKGUI_JSON_FE_7(M, T, __VA_ARGS__))
+#define DESKGUI_JSON_FE_9(M, T, x, ...) M(T, x), DESKGUI_JSON_EXPAND(DESKGUI_JSON_FE_8(M, T, __VA_ARGS__))
+#define DESKGUI_JSON_FE_10(M, T, x, ...) M(T, x), DESKGUI_JSON_EXPAND(DESKGUI_JSON_FE_9(M, T, __VA_ARGS__))
+#define DESKGUI_JSON_FE_11(M, T, x, ...) M(T, x), DESKGUI_JSON_EXPAND(DESKGUI_JSON_FE_10(M, T, __VA_ARGS__))
+#define DESKGUI_JSON_FE_12(M, T, x, ...) M(T, x), DESKGUI_JSON_EXPAND(DESKGUI_JSON_FE_11(M, T, __VA_ARGS__))
+#define DESKGUI_JSON_FE_13(M, T, x, ...) M(T, x), DESKGUI_JSON_EXPAND(DESKGUI_JSON_FE_12(M, T, __VA_ARGS__))
+#define DESKGUI_JSON_FE_14(M, T, x, ...) M(T, x), DESKGUI_JSON_EXPAND(DESKGUI_JSON_FE_13(M, T, __VA_ARGS__))
+#define DESKGUI_JSON_FE_15(M, T, x, ...) M(T, x), DESKGUI_JSON_EXPAND(DESKGUI_JSON_FE_14(M, T, __VA_ARGS__))
+#define DESKGUI_JSON_FE_16(M, T, x, ...) M(T, x), DESKGUI_JSON_EXPAND(DESKGUI_JSON_FE_15(M, T, __VA_ARGS__))
+#define DESKGUI_JSON_GET_FE(_1, _2, _3, _4, _5, _6, _7, _8, _9, _10, _11, _12, _13, _14, _15, _16, \
+                            NAME, ...)                                                           \
+  NAME
+#define DESKGUI_JSON_FOR_EACH(M, T, ...)                                                        \
+  DESKGUI_JSON_EXPAND(DESKGUI_JSON_GET_FE(                                                      \
+      __VA_ARGS__, DESKGUI_JSON_FE_16, DESKGUI_JSON_FE_15, DESKGUI_JSON_FE_14, DESKGUI_JSON_FE_13, \
+      DESKGUI_JSON_FE_12, DESKGUI_JSON_FE_11, DESKGUI_JSON_FE_10, DESKGUI_JSON_FE_9,             \
+      DESKGUI_JSON_FE_8, DESKGUI_JSON_FE_7, DESKGUI_JSON_FE_6, DESKGUI_JSON_FE_5,                \
+      DESKGUI_JSON_FE_4, DESKGUI_JSON_FE_3, DESKGUI_JSON_FE_2, DESKGUI_JSON_FE_1, )(M, T, __VA_ARGS__))
+
+#define DESKGUI_REFLECT(Type, ...)                                               \
+  [[maybe_unused]] inline auto deskguiFields(const Type*) {                      \
+    return std::make_tuple(DESKGUI_JSON_FOR_EACH(DESKGUI_JSON_FIELD, Type, __VA_ARGS__)); \
+  }
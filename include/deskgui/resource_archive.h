@@ -0,0 +1,38 @@
+/**
+ * deskgui - A powerful and flexible C++ library to create web-based desktop applications.
+ *
+ * Copyright (c) 2023 deskgui
+ * MIT License
+ */
+
+#pragma once
+
+#include <deskgui/resource_compiler.h>
+
+#include <string>
+
+namespace deskgui {
+
+  /**
+   * Loads a resource archive created with the resource_archive() CMake function.
+   *
+   * The file is memory mapped and the returned resources refer to the mapping, which stays open
+   * while any of them is alive. Pass them to Webview::loadResources to serve them without copies.
+   * The archive may be a standalone file or appended to another file, such as an executable.
+   *
+   * @param path The path of the archive.
+   * @return The resources stored in the archive.
+   * @throws std::runtime_error if the file cannot be mapped or is not a valid archive.
+   */
+  Resources loadResourceArchive(const std::string& path);
+
+  /**
+   * Loads the resource archive appended to the running executable with
+   * resource_archive(... APPEND_TO_TARGET ON).
+   *
+   * @return The resources stored in the archive.
+   * @throws std::runtime_error if the executable has no valid archive appended.
+   */
+  Resources loadAppendedResourceArchive();
+
+}  // namespace deskgui
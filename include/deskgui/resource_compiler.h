@@ -8,24 +8,185 @@
 #pragma once
 
 #include <array>
+#include <cstddef>
 #include <cstdint>
+#include <initializer_list>
+#include <iterator>
+#include <memory>
 #include <string>
+#include <string_view>
+#include <type_traits>
 #include <unordered_map>
 #include <vector>
 
 namespace deskgui {
 
+  /**
+   * Read-only bytes of a resource.
+   *
+   * The bytes are either owned, shared between copies, a view kept alive by an owner such as a
+   * mapped resource archive, or a view of static storage such as the arrays emitted by the
+   * resource compiler, which are never copied. Webviews serve all of them without copying them
+   * again.
+   */
+  class ResourceContent {
+  public:
+    ResourceContent() = default;
+
+    ResourceContent(std::vector<std::uint8_t> bytes) {
+      auto owned = std::make_shared<const std::vector<std::uint8_t>>(std::move(bytes));
+      data_ = owned->data();
+      size_ = owned->size();
+      owner_ = std::move(owned);
+    }
+
+    ResourceContent(std::initializer_list<std::uint8_t> bytes)
+        : ResourceContent(std::vector<std::uint8_t>(bytes)) {}
+
+    template <typename Iterator, typename = typename std::iterator_traits<Iterator>::value_type>
+    ResourceContent(Iterator first, Iterator last)
+        : ResourceContent(std::vector<std::uint8_t>(first, last)) {}
+
+    /**
+     * Creates a view of bytes that outlive every webview, without copying them.
+     */
+    static ResourceContent fromStatic(const std::uint8_t* data, std::size_t size) {
+      ResourceContent content;
+      content.data_ = data;
+      content.size_ = size;
+      return content;
+    }
+
+    template <std::size_t Size>
+    static ResourceContent fromStatic(const std::array<unsigned char, Size>& bytes) {
+      return fromStatic(bytes.data(), Size);
+    }
+
+    /**
+     * Creates a view of bytes that stay valid while owner is alive, without copying them.
+     */
+    static ResourceContent fromShared(std::shared_ptr<const void> owner, const std::uint8_t* data,
+                                      std::size_t size) {
+      ResourceContent content = fromStatic(data, size);
+      content.owner_ = std::move(owner);
+      return content;
+    }
+
+    [[nodiscard]] const std::uint8_t* data() const { return data_; }
+    [[nodiscard]] std::size_t size() const { return size_; }
+    [[nodiscard]] bool empty() const { return size_ == 0; }
+    [[nodiscard]] const std::uint8_t* begin() const { return data_; }
+    [[nodiscard]] const std::uint8_t* end() const { return data_ + size_; }
+
+    // View of size bytes starting at offset, sharing the owner. Both must be within bounds.
+    [[nodiscard]] ResourceContent slice(std::size_t offset, std::size_t size) const {
+      ResourceContent content = *this;
+      content.data_ = data_ + offset;
+      content.size_ = size;
+      return content;
+    }
+
+    // True when the bytes live in static storage.
+    [[nodiscard]] bool isStatic() const { return !owner_; }
+
+    // Keeps owned bytes alive while a webview is still reading them, null for static bytes.
+    [[nodiscard]] std::shared_ptr<const void> owner() const { return owner_; }
+
+  private:
+    std::shared_ptr<const void> owner_;
+    const std::uint8_t* data_{nullptr};
+    std::size_t size_{0};
+  };
+
   /**
    * Represents a resource, including its scheme, content and type.
    */
   struct Resource {
     std::string scheme;  // The URL scheme of resource (e.g., "static/assets/", "data/js/").
-    std::vector<std::uint8_t> content;  // The resource content
+    ResourceContent content;  // The resource content
     std::string mime;  // The resource mime (e.g., "text/html", "application/javascript", ...).
+    std::string encoding;  // Content encoding of content ("gzip", "br", "zstd"), empty if none.
+    std::string hash;  // Hash of the decoded content, served as its ETag. Empty if unknown.
   };
 
   using Resources = std::vector<Resource>;
 
+  /**
+   * Entry of a compiled resource pack. Every field refers to static storage.
+   */
+  struct ResourceEntry {
+    std::string_view path;
+    const std::uint8_t* data;
+    std::size_t size;
+    std::string_view mime;
+    std::string_view encoding;
+    std::string_view hash;
+
+    [[nodiscard]] Resource toResource() const {
+      return {std::string(path), ResourceContent::fromStatic(data, size), std::string(mime),
+              std::string(encoding), std::string(hash)};
+    }
+  };
+
+  /**
+   * Table of the entries of a compiled resource pack, sorted by path.
+   *
+   * The table is generated by the resource compiler as constant data, so creating a registry and
+   * looking up a path allocate nothing. Webviews turn an entry into a Resource on its first
+   * request only. The paths given to the PRELOAD and PRELOAD_LIST arguments of the compiler are
+   * listed in the order given, see ResourcePack::preload.
+   */
+  class ResourceRegistry {
+  public:
+    ResourceRegistry() = default;
+    ResourceRegistry(const ResourceEntry* const* entries, std::size_t size)
+        : entries_(entries), size_(size) {}
+    ResourceRegistry(const ResourceEntry* const* entries, std::size_t size,
+                     const std::string_view* preload, std::size_t preloadSize)
+        : entries_(entries), size_(size), preload_(preload), preloadSize_(preloadSize) {}
+
+    [[nodiscard]] const ResourceEntry* find(std::string_view path) const {
+      std::size_t first = 0;
+      std::size_t last = size_;
+      while (first < last) {
+        const std::size_t middle = first + (last - first) / 2;
+        const int order = entries_[middle]->path.compare(path);
+        if (order == 0) return entries_[middle];
+        if (order < 0) {
+          first = middle + 1;
+        } else {
+          last = middle;
+        }
+      }
+      return nullptr;
+    }
+
+    [[nodiscard]] std::size_t size() const { return size_; }
+    [[nodiscard]] bool empty() const { return size_ == 0; }
+    [[nodiscard]] const ResourceEntry& operator[](std::size_t index) const {
+      return *entries_[index];
+    }
+
+    // Paths of the entries pages load first, in the order they were given to the compiler.
+    [[nodiscard]] std::vector<std::string_view> preload() const {
+      return {preload_, preload_ + preloadSize_};
+    }
+
+    // Materializes every entry, for callers that need a Resources vector.
+    [[nodiscard]] Resources resources() const {
+      Resources resources;
+      resources.reserve(size_);
+      for (std::size_t i = 0; i < size_; ++i) resources.push_back(entries_[i]->toResource());
+      return resources;
+    }
+
+  private:
+    const ResourceEntry* const* entries_{nullptr};
+    std::size_t size_{0};
+    const std::string_view* preload_{nullptr};
+    std::size_t preloadSize_{0};
+  };
+
 #ifdef COMPILED_RESOURCES_ENABLED
   /**
    * Retrieves the compiled resources with the specified name.
@@ -34,5 +195,14 @@ namespace deskgui {
    * @return The compiled resources matching the specified name.
    */
   Resources getCompiledResources(const std::string& name);
+
+  /**
+   * Retrieves the registry of the compiled resources with the specified name, without
+   * materializing them. Pass it to Webview::loadResources to resolve resources on demand.
+   *
+   * @param name The name of the compiled resources.
+   * @return The registry of the compiled resources, empty if there is no such pack.
+   */
+  ResourceRegistry getCompiledResourceRegistry(const std::string& name);
 #endif
 }  // namespace deskgui
@@ -0,0 +1,80 @@
+/**
+ * deskgui - A powerful and flexible C++ library to create web-based desktop applications.
+ *
+ * Copyright (c) 2023 deskgui
+ * MIT License
+ */
+
+#pragma once
+
+#include <deskgui/resource_compiler.h>
+
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace deskgui {
+
+  namespace utils {
+    class ResourceIndex;
+  }
+
+  /**
+   * Immutable set of resources that any number of webviews can serve at once.
+   *
+   * A pack is created once, for example with std::make_shared<const ResourcePack>(resources), and
+   * shared by reference: loading it into several webviews copies nothing. Requests in flight keep
+   * the pack they started with alive, so a webview can swap its pack at any time.
+   *
+   * The pages of a pack with a preload list are served with a <link rel="preload"> per listed
+   * resource in their head, so the webview requests them all at once instead of as the page is
+   * parsed.
+   */
+  class ResourcePack {
+  public:
+    /**
+     * Creates a pack serving the resources of a vector, such as the ones of a resource archive.
+     *
+     * @param preload Paths of the resources the pages load first, such as "js/app.js".
+     */
+    explicit ResourcePack(Resources resources, std::vector<std::string> preload = {});
+
+    /**
+     * Creates a pack serving the entries of a compiled registry, each one resolved on its first
+     * request.
+     */
+    explicit ResourcePack(const ResourceRegistry& registry);
+
+    ~ResourcePack();
+
+    ResourcePack(const ResourcePack&) = delete;
+    ResourcePack& operator=(const ResourcePack&) = delete;
+
+    /**
+     * Finds the resource served at a path relative to the origin, such as "index.html".
+     *
+     * @return The resource, valid as long as the pack, or nullptr if there is none.
+     */
+    [[nodiscard]] const Resource* find(std::string_view path) const;
+
+    /**
+     * Paths of the resources the pages of the pack load first, in preload order.
+     */
+    [[nodiscard]] const std::vector<std::string>& preload() const { return preload_; }
+
+    [[nodiscard]] std::size_t size() const { return resources_.size() + registry_.size(); }
+    [[nodiscard]] bool empty() const { return size() == 0; }
+
+  private:
+    const Resources resources_;
+    const std::unique_ptr<utils::ResourceIndex> index_;
+    const ResourceRegistry registry_;
+    const std::vector<std::string> preload_;
+    mutable std::mutex resolvedMutex_;
+    mutable std::unordered_map<std::string_view, std::unique_ptr<const Resource>> resolved_;
+  };
+
+}  // namespace deskgui
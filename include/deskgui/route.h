@@ -0,0 +1,78 @@
+/**
+ * deskgui - A powerful and flexible C++ library to create web-based desktop applications.
+ *
+ * Copyright (c) 2023 deskgui
+ * MIT License
+ */
+
+#pragma once
+
+#include <functional>
+#include <map>
+#include <memory>
+#include <string>
+#include <string_view>
+
+namespace deskgui {
+
+  /**
+   * @brief Request of the page handled by a route, see Webview::addRoute.
+   */
+  struct RouteRequest {
+    std::string method;  ///< HTTP method, such as "GET" or "POST"
+    std::string url;     ///< Full URL, including the origin
+    std::string path;    ///< Path below the origin, without the query
+    std::string query;   ///< Query string, without the leading '?'
+    std::string body;    ///< Request body, empty for GET requests
+    std::map<std::string, std::string> params;  ///< Values of the ":name" and "*" segments
+  };
+
+  /**
+   * @brief Response of a route, written while the page reads it.
+   *
+   * The status and headers are sent with the first write, or with end if nothing is written.
+   * Responses are cheap to copy and may be completed from any thread, after the handler
+   * returned. A response whose last copy is destroyed without calling end is ended then.
+   */
+  class RouteResponse {
+  public:
+    struct State;
+
+    explicit RouteResponse(std::shared_ptr<State> state);
+
+    /**
+     * @brief Sets the status of the response. Defaults to 200 OK.
+     *
+     * @param status The HTTP status code.
+     * @param reason The reason phrase, the standard one when empty.
+     */
+    void setStatus(int status, const std::string& reason = {});
+
+    /**
+     * @brief Adds a header to the response, such as "Content-Type".
+     */
+    void setHeader(const std::string& name, const std::string& value);
+
+    /**
+     * @brief Sends a chunk of the body.
+     *
+     * Blocks while the page has not read the previous chunks, so a slow reader pushes back on
+     * the handler, which keeps its resource worker meanwhile (see
+     * WebviewOptions::kResourceWorkerThreads).
+     *
+     * @return false if the page stopped reading, the rest of the body can be skipped.
+     */
+    bool write(std::string_view chunk);
+
+    /**
+     * @brief Sends the last chunk of the body and completes the response.
+     */
+    void end(std::string_view chunk = {});
+
+  private:
+    std::shared_ptr<State> state_;
+  };
+
+  using RouteHandler = std::function<void(const RouteRequest&, RouteResponse)>;
+
+}  // namespace deskgui
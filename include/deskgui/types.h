@@ -8,8 +8,11 @@
 #pragma once
 
 #include <atomic>
+#include <chrono>
 #include <cstddef>
+#include <cstdint>
 #include <functional>
+#include <map>
 #include <string>
 #include <string_view>
 
@@ -44,6 +47,52 @@ namespace deskgui {
   // Callback function type for receiving messages.
   using MessageCallback = std::function<void(std::string_view)>;
 
+  // Callback receiving the result of a script encoded as compact JSON, or the error message when
+  // the script failed.
+  using ScriptCallback = std::function<void(bool success, std::string_view result)>;
+
+  // Thread on which a webview callback is invoked.
+  enum class CallbackThread {
+    kMain,   // The main (UI) thread.
+    kWorker  // A background message worker, see WebviewOptions::kMessageWorkerThreads.
+  };
+
+  // What a full bridge message queue does with a new message.
+  enum class QueuePolicy {
+    kBlock,       // Wait for space; the main thread never waits and overfills the queue instead.
+    kDropOldest,  // Drop the oldest queued message.
+    kCoalesce     // Replace the queued message with the same key, otherwise drop the oldest.
+  };
+
+  // Counters of a bridge message queue.
+  struct BridgeQueueStats {
+    std::size_t queued{0};   // Messages currently waiting to be delivered.
+    std::size_t dropped{0};  // Messages dropped or replaced since the webview was created.
+  };
+
+  // Counters of the requests of the page to one path of the custom scheme.
+  struct ResourcePathStats {
+    std::size_t hits{0};    // Requests answered with a 2xx or 3xx status, 304s included.
+    std::size_t misses{0};  // Requests nothing was served for, answered with 404.
+    std::size_t errors{0};  // Requests answered with another 4xx or 5xx status.
+    std::uint64_t bytes{0};  // Body bytes of the responses, except streamed route responses.
+    std::chrono::microseconds totalLatency{0};  // Time until the response, over all requests.
+    std::chrono::microseconds maxLatency{0};
+  };
+
+  // Counters of the requests of the page to the custom scheme since the webview was created.
+  struct ResourceStats {
+    // Paths counted apart; requests to further paths are counted together under kOtherPaths.
+    static constexpr std::size_t kMaxPaths = 1024;
+    static constexpr std::string_view kOtherPaths = "*";
+
+    std::size_t hits{0};
+    std::size_t misses{0};
+    std::size_t errors{0};
+    std::uint64_t bytes{0};
+    std::map<std::string, ResourcePathStats> paths;  // By path below the origin, without query.
+  };
+
   using UniqueId = size_t;
 
   struct UniqueIdGenerator {
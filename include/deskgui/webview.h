@@ -9,10 +9,18 @@
 
 #include <deskgui/app_handler.h>
 #include <deskgui/event_bus.h>
+#include <deskgui/json.h>
+#include <deskgui/resource_archive.h>
 #include <deskgui/resource_compiler.h>
+#include <deskgui/resource_pack.h>
+#include <deskgui/route.h>
 #include <deskgui/types.h>
 #include <deskgui/webview_options.h>
 
+#include <future>
+#include <memory>
+#include <stdexcept>
+
 namespace deskgui {
   class Window;
 
@@ -27,6 +35,7 @@ namespace deskgui {
    */
   class Webview {
   private:
+    friend class App;
     friend class Window;
 
     /**
@@ -158,6 +167,59 @@ namespace deskgui {
      */
     void loadResources(Resources&& resources);
 
+    /**
+     * @brief Serves a resource pack shared with other web views, without copying it.
+     *
+     * Replaces the resources loaded before. The swap is atomic: requests already in flight finish
+     * with the previous pack, the next ones are served from the new one.
+     *
+     * @param pack The pack to serve, nullptr serves no resources.
+     */
+    void loadResources(std::shared_ptr<const ResourcePack> pack);
+
+    /**
+     * @brief Mounts a pack as a named layer over the resources loaded before.
+     *
+     * Layers are looked up from the last mounted one down to the pack given to loadResources,
+     * the first layer serving a path answers, so plugin assets and developer overrides can
+     * shadow the embedded bundle. Mounting a name again swaps that layer in place: it keeps its
+     * precedence and the other layers, with their caches, are left untouched.
+     *
+     * @param layer The name of the layer.
+     * @param pack The resources of the layer, nullptr unmounts it.
+     * @throws std::invalid_argument If the name is empty.
+     */
+    void mountResources(const std::string& layer, std::shared_ptr<const ResourcePack> pack);
+
+    /**
+     * @brief Mounts a directory on disk as a named layer, see mountResources.
+     *
+     * The directory mirrors the root of the origin: "index.html" is looked up as
+     * "<directory>/index.html", and paths without a file fall through to the layers below.
+     * Files are read in the background when requested.
+     *
+     * @param layer The name of the layer.
+     * @param directory The directory of the layer.
+     * @throws std::invalid_argument If the name is empty or the directory does not exist.
+     */
+    void mountDirectory(const std::string& layer, const std::string& directory);
+
+    /**
+     * @brief Removes a layer mounted with mountResources or mountDirectory.
+     *
+     * @param layer The name of the layer.
+     */
+    void unmountResources(const std::string& layer);
+
+    /**
+     * @brief Loads the resources of a registry, resolving each one on its first request.
+     *
+     * Replaces the resources loaded before. Resources that are never requested cost no memory.
+     *
+     * @param registry Registry returned by getCompiledResourceRegistry.
+     */
+    void loadResources(const ResourceRegistry& registry);
+
     /**
      * @brief Serves a resource identified by its URL scheme.
      *
@@ -168,10 +230,60 @@ namespace deskgui {
     void serveResource(const std::string& resourceUrl);
 
     /**
-     * @brief Clears all the resources that have been loaded into the application.
+     * @brief Serves the files of a directory on disk under a path of the custom scheme.
+     *
+     * Files are read in the background when requested, so they can change while the web view
+     * runs. Loaded resources and layers take precedence over the files, and directories served
+     * at longer paths over those at shorter ones: a missing file falls through to the next one. A
+     * request for a directory serves its index.html. Mounting the same path again replaces the
+     * directory, an empty directory unmounts it.
+     *
+     * For example: serveDirectory("assets", "/path/to/assets") serves
+     * "/path/to/assets/logo.png" at "webview://localhost/assets/logo.png".
+     *
+     * @param mountPath The path the files are served at, empty for the root.
+     * @param directory The directory to serve.
+     * @throws std::invalid_argument If the directory does not exist.
+     */
+    void serveDirectory(const std::string& mountPath, const std::string& directory);
+
+    /**
+     * @brief Answers requests of the page to a path of the custom scheme with a C++ handler.
+     *
+     * The handler runs on a background thread and writes its response while the page reads it,
+     * so the page can fetch() dynamic data without going through the message bridge. Routes
+     * take precedence over loaded resources and served directories, the first matching route
+     * answers. Adding a route with the same pattern replaces it.
+     *
+     * For example: addRoute("api/users/:id", handler) answers
+     * fetch("webview://localhost/api/users/42") with request.params["id"] == "42". A final "*"
+     * segment captures the rest of the path in request.params["*"].
+     *
+     * @param pattern The path pattern, relative to the origin.
+     * @param handler The function writing the response.
+     */
+    void addRoute(const std::string& pattern, RouteHandler handler);
+
+    /**
+     * @brief Removes a route added with addRoute.
+     *
+     * @param pattern The pattern given to addRoute.
+     */
+    void removeRoute(const std::string& pattern);
+
+    /**
+     * @brief Clears all the resources that have been loaded into the application, the layers
+     * mounted and the directories served.
      */
     void clearResources();
 
+    /**
+     * @brief Gets the pack given to loadResources, to load it into other web views.
+     *
+     * @return The pack, nullptr if no resources are loaded.
+     */
+    [[nodiscard]] std::shared_ptr<const ResourcePack> resourcePack() const;
+
     /**
      * @brief Gets the current URL of the web view.
      *
@@ -195,16 +307,99 @@ namespace deskgui {
      */
     void executeScript(const std::string& script);
 
+    /**
+     * @brief Evaluates a script in the web view and retrieves its result.
+     *
+     * The engine encodes the value of the script as compact JSON and returns it with the script
+     * completion, so reading page state takes a single round trip. The callback runs on the main
+     * thread.
+     *
+     * @param script The script to evaluate.
+     * @param callback The callback receiving the JSON result or the error message.
+     */
+    void evaluate(const std::string& script, ScriptCallback callback);
+
+    /**
+     * @brief Evaluates a script in the web view and deserializes its result.
+     *
+     * The future holds a std::runtime_error when the script fails or its result does not match
+     * the requested type. Since the result is delivered on the main thread, do not wait for the
+     * future on the main thread.
+     *
+     * Example:
+     * @code{.cpp}
+     * std::future<std::string> title = webview->evaluate<std::string>("document.title");
+     * @endcode
+     *
+     * @tparam T The type of the result, json::RawJson by default.
+     * @param script The script to evaluate.
+     * @return A future holding the result.
+     */
+    template <typename T = json::RawJson> [[nodiscard]] std::future<T> evaluate(
+        const std::string& script) {
+      auto promise = std::make_shared<std::promise<T>>();
+      auto future = promise->get_future();
+      evaluate(script, [promise](bool success, std::string_view result) {
+        T value{};
+        if (!success) {
+          promise->set_exception(std::make_exception_ptr(std::runtime_error(std::string(result))));
+        } else if (!json::parse(result, value)) {
+          promise->set_exception(std::make_exception_ptr(
+              std::runtime_error("Script result does not match the requested type")));
+        } else {
+          promise->set_value(std::move(value));
+        }
+      });
+      return future;
+    }
+
     /**
      * @brief Adds a callback function with the specified name.
      *
      * The callback is exposed as a global JavaScript function accessible via
-     * window.<callback-key>(message).
+     * window.<callback-key>(message). Adding a callback with a key already in use replaces the
+     * previous callback of that key.
      *
      * @param key The name (key) of the callback.
      * @param callback The callback function to be invoked when the JavaScript function is called.
+     * @param thread The thread the callback runs on. CallbackThread::kWorker only takes effect
+     * when WebviewOptions::kMessageWorkerThreads is set.
+     */
+    void addCallback(const std::string& key, MessageCallback callback,
+                     CallbackThread thread = CallbackThread::kMain);
+
+    /**
+     * @brief Adds a callback whose arguments are deserialized into C++ types.
+     *
+     * The callback is exposed as a global JavaScript function accessible via
+     * window.<callback-key>(arg0, arg1, ...). Each argument is deserialized straight from the
+     * message token stream into the corresponding type, without an intermediate DOM. Types other
+     * than the standard ones supported by json::read must be described with DESKGUI_REFLECT.
+     * Messages whose arguments do not match the types are ignored. Adding a callback with a key
+     * already in use replaces the previous callback of that key.
+     *
+     * Example:
+     * @code{.cpp}
+     * struct Point { int x; int y; };
+     * DESKGUI_REFLECT(Point, x, y)
+     *
+     * webview->addCallback<Point, std::string>("move", [](const Point& to, const std::string& id) {
+     *   // window.move({x: 1, y: 2}, "cursor")
+     * });
+     * @endcode
+     *
+     * @tparam Args The argument types of the callback.
+     * @param key The name (key) of the callback.
+     * @param callback The callable invoked with the deserialized arguments.
+     * @param thread The thread the callback runs on. CallbackThread::kWorker only takes effect
+     * when WebviewOptions::kMessageWorkerThreads is set.
      */
-    void addCallback(const std::string& key, MessageCallback callback);
+    template <typename... Args, typename Callable,
+              typename = std::enable_if_t<(sizeof...(Args) > 0)>>
+    void addCallback(const std::string& key, Callable&& callback,
+                     CallbackThread thread = CallbackThread::kMain) {
+      addTypedCallback(key, json::bind<Args...>(std::forward<Callable>(callback)), thread);
+    }
 
     /**
      * @brief Removes the callback function for the specified key.
@@ -216,9 +411,55 @@ namespace deskgui {
     /**
      * @brief Sends a message to the webview.
      *
+     * The message is delivered to window.webview.onMessage. When
+     * WebviewOptions::kOutgoingQueueCapacity is set, messages wait in a bounded queue until the
+     * page has processed the previous ones.
+     *
      * @param message The message to send.
+     * @param key Optional key used by the "coalesce" queue policy: a queued message with the same
+     * key is replaced instead of growing the queue.
+     */
+    void postMessage(const std::string& message, const std::string& key = {});
+
+    /**
+     * @brief Gets the number of messages received from the page that are not dispatched yet.
+     *
+     * Only messages handed to the background workers (see WebviewOptions::kMessageWorkerThreads)
+     * are queued; without workers this is always 0.
+     *
+     * @return The number of queued messages.
+     */
+    [[nodiscard]] std::size_t messageQueueDepth() const;
+
+    /**
+     * @brief Gets the counters of the queue of messages sent to the page with postMessage.
+     *
+     * @return The queued and dropped messages, see WebviewOptions::kOutgoingQueueCapacity.
      */
-    void postMessage(const std::string& message);
+    [[nodiscard]] BridgeQueueStats outgoingQueueStats() const;
+
+    /**
+     * @brief Gets the counters of the queue of messages received from the page.
+     *
+     * Queued messages are the ones received and not dispatched yet; dropped messages are the ones
+     * the page discarded, see WebviewOptions::kIncomingQueueCapacity.
+     *
+     * @return The queued and dropped messages.
+     */
+    [[nodiscard]] BridgeQueueStats incomingQueueStats() const;
+
+    /**
+     * @brief Gets the counters of the requests of the page to the custom scheme.
+     *
+     * Every request is counted, whether a route, a resource layer, a served directory or nothing
+     * answered it, with the time it took to answer. Paths never requested point at dead assets,
+     * the most requested ones at assets worth preloading. Queries and fragments are left out of
+     * the paths, and once ResourceStats::kMaxPaths paths are counted the requests to new ones
+     * are counted under ResourceStats::kOtherPaths, pages generating URLs cannot grow the map.
+     *
+     * @return A snapshot of the counters since the webview was created.
+     */
+    [[nodiscard]] ResourceStats resourceStats() const;
 
     /**
      * @brief Resizes the web view to the specified size.
@@ -261,6 +502,11 @@ namespace deskgui {
     }
 
   private:
+    void addTypedCallback(const std::string& key, json::Binding binding, CallbackThread thread);
+
+    // Moves a webview created in advance to a window under the name it is handed out with.
+    void adopt(const std::string& name, void* window);
+
     std::shared_ptr<Impl> impl_{nullptr};
 
     EventBus* events_;
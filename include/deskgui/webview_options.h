@@ -62,6 +62,12 @@ namespace deskgui {
       return T();
     }
 
+    /**
+     * @brief Checks if both hold the same options with the same values.
+     */
+    inline bool operator==(const WebviewOptions& other) const { return options == other.options; }
+    inline bool operator!=(const WebviewOptions& other) const { return !(*this == other); }
+
   private:
     std::unordered_map<std::string, Option> options;
 
@@ -104,6 +110,23 @@ namespace deskgui {
     /// Defaults to false (synchronous/blocking).
     static constexpr auto kAsyncCreation = "async-creation";
 
+    /// Name of the context group of the webview. Webviews of a group share one web context: its
+    /// cache, cookies, custom scheme registration and network process. Ephemeral and persistent
+    /// webviews (kEphemeralSession) of the same name are in separate groups, so private data is
+    /// never written to disk.
+    /// - macOS: The webviews share a data store, persistent groups the default one of every
+    ///   persistent webview. Their process pool only shares web processes before macOS 12
+    /// - Linux: The webviews share a WebKitWebContext
+    /// - Windows: No effect, webviews share the processes of their user data folder
+    /// Defaults to none: webviews share the default context, ephemeral ones get their own.
+    static constexpr auto kContextGroup = "context-group";
+
+    /// Maximum number of web processes started for the context group of the webview. Once the
+    /// group has that many, new webviews share the web process of an existing one, which keeps
+    /// memory bounded with many webviews. Linux only.
+    /// Defaults to 0: WebKit decides, usually a process per webview.
+    static constexpr auto kWebProcessLimit = "web-process-limit";
+
     /// Scheme name used to serve embedded resources via loadResources/serveResource.
     /// Defaults to "webview", giving an origin of "webview://localhost/". Override
     /// when the default scheme is incompatible with content loaded inside the
@@ -117,6 +140,54 @@ namespace deskgui {
     /// Host used in the resource origin alongside kCustomSchemeProtocol.
     /// Defaults to "localhost", giving an origin of "<protocol>://localhost/".
     static constexpr auto kCustomSchemeHost = "custom-scheme-host";
+
+    /// Number of background threads that parse messages received from the page and run the
+    /// callbacks added with CallbackThread::kWorker. Messages are parsed in arrival order and
+    /// callbacks of the same key always run in order. Main thread callbacks and the
+    /// WebviewOnMessage event are posted back to the main thread.
+    /// Defaults to 0: messages are parsed and dispatched on the main thread.
+    static constexpr auto kMessageWorkerThreads = "message-worker-threads";
+
+    /// Maximum number of messages sent with Webview::postMessage that wait for the page to
+    /// process the previous ones. Messages are delivered in batches and the next batch is only
+    /// sent once the page has run the current one, so a slow page pushes back on the sender.
+    /// Defaults to 0: messages are delivered immediately and never dropped.
+    static constexpr auto kOutgoingQueueCapacity = "outgoing-queue-capacity";
+
+    /// Policy applied when the outgoing queue is full: "block", "drop-oldest" or "coalesce".
+    /// Coalescing uses the key given to Webview::postMessage. Defaults to "drop-oldest".
+    static constexpr auto kOutgoingQueuePolicy = "outgoing-queue-policy";
+
+    /// Maximum number of messages posted by the page with window.webview.postMessage that are
+    /// not dispatched yet. Further messages wait inside the page until the native side catches
+    /// up. Defaults to 0: messages are sent immediately.
+    static constexpr auto kIncomingQueueCapacity = "incoming-queue-capacity";
+
+    /// Policy applied when the incoming queue is full: "block", "drop-oldest" or "coalesce".
+    /// With "block" the promise returned by window.webview.postMessage resolves once the message
+    /// is sent, and is rejected while as many messages as the capacity wait in the page.
+    /// Coalescing uses the callback key. Defaults to "drop-oldest".
+    static constexpr auto kIncomingQueuePolicy = "incoming-queue-policy";
+
+    /// Maximum number of bytes of compressed resources kept decoded in memory, and of files
+    /// served with Webview::serveDirectory kept read. Only files up to 1 MiB are kept, larger
+    /// ones are streamed from disk. Least recently used resources are decoded or read again on
+    /// their next request.
+    /// Defaults to 32 MiB.
+    static constexpr auto kResourceCacheSize = "resource-cache-size";
+
+    /// Number of background threads reading the files served with Webview::serveDirectory and
+    /// running the handlers added with Webview::addRoute. A handler streaming its response holds
+    /// its thread until the page has read all but the last MiB of it, and a file larger than
+    /// 1 MiB holds it until the page has read all but its last 256 KiB, so raise the count when
+    /// long responses go to slow readers.
+    /// Defaults to 2.
+    static constexpr auto kResourceWorkerThreads = "resource-worker-threads";
+
+    /// Milliseconds after which a request to the custom scheme is reported with the
+    /// WebviewSlowResource event, see Webview::resourceStats.
+    /// Defaults to 0: slow requests are not reported.
+    static constexpr auto kSlowResourceThreshold = "slow-resource-threshold";
   };
 
 }  // namespace deskgui
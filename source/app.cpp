@@ -5,6 +5,8 @@
  * MIT License
  */
 
+#include <algorithm>
+
 #include "interfaces/app_impl.h"
 
 using namespace deskgui;
@@ -67,6 +69,111 @@ Window* App::getWindow(const std::string& name) const {
   return impl_->getWindow(name);
 }
 
+void App::Impl::setWebviewPool(std::size_t size, const WebviewOptions& options,
+                               std::shared_ptr<const ResourcePack> resources,
+                               AppHandler* appHandler) {
+  if (!webviewPool_) webviewPool_ = std::make_shared<WebviewPool>();
+  auto& pool = *webviewPool_;
+
+  // Webviews created with other options or resources are of no use anymore.
+  if (pool.options != options || pool.resources != resources) pool.entries.clear();
+  while (pool.entries.size() > size) pool.entries.pop_back();
+  pool.size = size;
+  pool.options = options;
+  pool.resources = std::move(resources);
+  pool.appHandler = appHandler;
+  refillWebviewPool(webviewPool_);
+}
+
+void App::Impl::refillWebviewPool(const std::shared_ptr<WebviewPool>& pool) {
+  if (pool->refilling || pool->entries.size() >= pool->size) return;
+  // WebView2 creates its webviews asynchronously, the next one is created once the last one is
+  // ready. A pending webview destroyed with the pool entries no longer holds the refill back.
+  if (auto pending = pool->pending.lock(); pending && !pending->isReady()) return;
+
+  // One webview per iteration of the event loop, each creation blocks the main thread.
+  pool->refilling = true;
+  pool->appHandler->postOnMainThread([weakPool = std::weak_ptr<WebviewPool>(pool)] {
+    auto pool = weakPool.lock();
+    if (!pool) return;
+    pool->refilling = false;
+    if (pool->entries.size() >= pool->size) return;
+
+    const auto name = "deskgui-pool-" + std::to_string(pool->created++);
+    WebviewPool::Entry entry;
+    try {
+      entry.host.reset(new Window(name, pool->appHandler, nullptr));
+      entry.webview.reset(new Webview(name, pool->appHandler, entry.host->getContentView(),
+                                      pool->options));
+    } catch ([[maybe_unused]] const std::exception& e) {
+      return;  // createWebview builds its webviews as if there were no pool.
+    }
+    if (pool->resources) {
+      entry.webview->onReady([webview = std::weak_ptr<Webview>(entry.webview),
+                              resources = pool->resources] {
+        if (auto ready = webview.lock()) ready->loadResources(resources);
+      });
+    }
+    pool->pending = entry.webview;
+    auto& webview = *entry.webview;
+    pool->entries.push_back(std::move(entry));
+    // Called right away by webviews created synchronously.
+    webview.onReady([weakPool = std::weak_ptr<WebviewPool>(pool)] {
+      if (auto pool = weakPool.lock()) refillWebviewPool(pool);
+    });
+  });
+}
+
+std::size_t App::Impl::pooledWebviewCount() const {
+  if (!webviewPool_) return 0;
+  const auto& entries = webviewPool_->entries;
+  return static_cast<std::size_t>(std::count_if(
+      entries.begin(), entries.end(), [](const auto& entry) { return entry.webview->isReady(); }));
+}
+
+std::shared_ptr<Webview> App::Impl::takePooledWebview(const std::string& name, void* window,
+                                                      const WebviewOptions& options) {
+  if (!webviewPool_ || webviewPool_->options != options) return nullptr;
+
+  auto& entries = webviewPool_->entries;
+  const auto ready = std::find_if(entries.begin(), entries.end(),
+                                  [](const auto& entry) { return entry.webview->isReady(); });
+  if (ready == entries.end()) return nullptr;
+
+  // The webview leaves its hidden window before the window is destroyed.
+  auto webview = std::move(ready->webview);
+  webview->adopt(name, window);
+  entries.erase(ready);
+  refillWebviewPool(webviewPool_);
+  return webview;
+}
+
+void App::setWebviewPool(std::size_t size, const WebviewOptions& options,
+                         std::shared_ptr<const ResourcePack> resources) {
+  if (!isMainThread()) {
+    return dispatchOnMainThread([this, size, options, resources] {
+      setWebviewPool(size, options, resources);
+    });
+  }
+  impl_->setWebviewPool(size, options, std::move(resources), getHandler());
+}
+
+std::size_t App::pooledWebviewCount() const {
+  if (!isMainThread()) {
+    return dispatchOnMainThread([this] { return pooledWebviewCount(); });
+  }
+  return impl_->pooledWebviewCount();
+}
+
+std::shared_ptr<Webview> App::takePooledWebview(const std::string& name, void* window,
+                                                const WebviewOptions& options) {
+  if (!isMainThread()) {
+    return dispatchOnMainThread(
+        [this, name, window, options] { return takePooledWebview(name, window, options); });
+  }
+  return impl_->takePooledWebview(name, window, options);
+}
+
 std::string_view App::getName() const { return impl_->getName(); }
 
 bool App::isRunning() const { return impl_->isRunning(); }
@@ -10,6 +10,7 @@
 #include <deskgui/app.h>
 
 #include <atomic>
+#include <deque>
 #include <future>
 #include <set>
 #include <thread>
@@ -27,6 +28,12 @@ namespace deskgui {
     void destroyWindow(const std::string& name);
     [[nodiscard]] Window* getWindow(const std::string& name) const;
 
+    void setWebviewPool(std::size_t size, const WebviewOptions& options,
+                        std::shared_ptr<const ResourcePack> resources, AppHandler* appHandler);
+    [[nodiscard]] std::size_t pooledWebviewCount() const;
+    [[nodiscard]] std::shared_ptr<Webview> takePooledWebview(const std::string& name, void* window,
+                                                             const WebviewOptions& options);
+
     [[nodiscard]] inline std::string_view getName() const { return name_; }
 
     void run();
@@ -39,6 +46,27 @@ namespace deskgui {
     void dispatch(DispatchTask&& task);
 
   private:
+    /**
+     * Webviews created in advance, each one in a hidden window of its own until handed out.
+     */
+    struct WebviewPool {
+      struct Entry {
+        std::unique_ptr<Window> host;
+        std::shared_ptr<Webview> webview;  // Destroyed before its window.
+      };
+
+      std::size_t size{0};
+      WebviewOptions options;
+      std::shared_ptr<const ResourcePack> resources;
+      AppHandler* appHandler{nullptr};
+      std::deque<Entry> entries;
+      std::size_t created{0};  // Numbers the hidden windows.
+      bool refilling{false};   // A refill is posted to the main thread.
+      std::weak_ptr<Webview> pending;  // The last webview created, refills wait until it is ready.
+    };
+
+    static void refillWebviewPool(const std::shared_ptr<WebviewPool>& pool);
+
     std::unique_ptr<Platform> platform_{nullptr};
 
     std::string name_;
@@ -46,5 +74,6 @@ namespace deskgui {
     std::thread::id mainThreadId_;
 
     std::unordered_map<std::string, std::unique_ptr<Window>> windows_;
+    std::shared_ptr<WebviewPool> webviewPool_;
   };
 }  // namespace deskgui
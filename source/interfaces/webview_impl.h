@@ -10,12 +10,26 @@
 #include <deskgui/event_bus.h>
 #include <deskgui/webview.h>
 
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <functional>
+#include <map>
 #include <mutex>
+#include <optional>
+#include <shared_mutex>
 #include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "utils/bounded_queue.h"
+#include "utils/chunked_body.h"
+#include "utils/lru_cache.h"
+#include "utils/worker_pool.h"
 
 namespace deskgui {
 
-  class Webview::Impl {
+  class Webview::Impl : public std::enable_shared_from_this<Webview::Impl> {
   public:
     class Platform;
 
@@ -40,6 +54,35 @@ namespace deskgui {
     [[nodiscard]] inline const std::string& getOrigin() const { return origin_; }
 
     [[nodiscard]] inline std::string getName() const { return name_; }
+    inline void setName(const std::string& name) { name_ = name; }
+    void reparent(void* window);  // Moves the native view to another window, platform specific.
+
+    /**
+     * Request for a loaded resource, with the request headers the responses depend on.
+     */
+    struct ResourceRequest {
+      std::string url;
+      std::string range;        // Range header, empty if none.
+      std::string ifNoneMatch;  // If-None-Match header, empty if none.
+      std::string method{"GET"};
+      std::string body;
+      bool streaming{true};  // Whether the platform reads ResourceResponse::stream while written.
+    };
+
+    /**
+     * Response to a ResourceRequest, translated by each platform into its own response type.
+     */
+    struct ResourceResponse {
+      int status{200};
+      std::string reason{"OK"};
+      std::vector<std::pair<std::string, std::string>> headers;
+      std::string mime;
+      ResourceContent body;  // A slice of the resource for partial responses.
+      std::shared_ptr<utils::ChunkedBody> stream;  // Replaces body when written while read.
+    };
+
+    // Completes a ResourceRequest on the main thread, without a response if nothing is served.
+    using ResourceResponder = std::function<void(std::optional<ResourceResponse>)>;
 
     [[nodiscard]] bool isReady() const;
     void onReady(std::function<void()> callback);
@@ -60,36 +103,183 @@ namespace deskgui {
     void navigate(const std::string& url);
     void loadFile(const std::string& path);
     void loadHTMLString(const std::string& html);
-    void loadResources(Resources&& resources);
+    void loadResourcePack(std::shared_ptr<const ResourcePack> pack);
+    void mountResources(const std::string& name, std::shared_ptr<const ResourcePack> pack);
+    void mountDirectory(const std::string& name, const std::string& directory);
+    void unmountResources(const std::string& name);
     void serveResource(const std::string& resourceUrl);
+    void serveDirectory(const std::string& mountPath, const std::string& directory);
+    void addRoute(const std::string& pattern, RouteHandler handler);
+    void removeRoute(const std::string& pattern);
     void clearResources();
+    [[nodiscard]] std::shared_ptr<const ResourcePack> resourcePack() const;
+    [[nodiscard]] std::optional<ResourceContent> decodedContent(const Resource& resource);
+    void handleResourceRequest(ResourceRequest request, ResourceResponder respond);
     [[nodiscard]] std::string getUrl();
 
     // Functionality
-    void addCallback(const std::string& key, MessageCallback callback);
+    void addCallback(const std::string& key, MessageCallback callback, CallbackThread thread);
+    void addTypedCallback(const std::string& key, json::Binding binding, CallbackThread thread);
     void removeCallback(const std::string& key);
-    void postMessage(const std::string& message);
+    void postMessage(const std::string& message, const std::string& key);
     void injectScript(const std::string& script);
     void executeScript(const std::string& script);
-    void onMessage(const std::string& message);
+    void setCallbackScript(const std::string& key, const std::string& script);
+    void evaluateScript(const std::string& script, ScriptCallback callback);
+    void onMessage(std::string message);
+    [[nodiscard]] inline std::size_t messageQueueDepth() const { return queuedMessages_.load(); }
+    [[nodiscard]] inline bool hasOutgoingQueue() const { return outgoing_ != nullptr; }
+    [[nodiscard]] BridgeQueueStats outgoingQueueStats() const;
+    [[nodiscard]] BridgeQueueStats incomingQueueStats() const;
+    [[nodiscard]] ResourceStats resourceStats() const;
 
     [[nodiscard]] inline AppHandler* application() const { return appHandler_; }
     [[nodiscard]] inline EventBus& events() { return events_; }
 
   private:
+    struct Callback {
+      json::Binding binding;
+      std::shared_ptr<utils::SerialQueue> queue;  // Set when the callback runs on the workers.
+      bool internal{false};                       // Bridge traffic, hidden from the page events.
+    };
+
+    /**
+     * Layer of the resources served by the webview, either a pack or a directory. The directories
+     * given to serveDirectory are disk layers below the others, serving a path of the origin.
+     */
+    struct ResourceLayer {
+      std::string name;  // Empty for the pack given to loadResources, the path if served.
+      std::shared_ptr<const ResourcePack> pack;
+      std::filesystem::path directory;  // Set for disk layers, read on the resource workers.
+      std::string path;                 // Served path, empty for the root or ending with '/'.
+      bool served{false};               // Added with serveDirectory.
+    };
+    using ResourceLayers = std::vector<ResourceLayer>;
+
+    struct DecodedContent {
+      ResourceContent source;  // Keeps the bytes the entry is keyed by alive.
+      ResourceContent decoded;
+    };
+
+    struct Route {
+      std::string pattern;  // Relative to the origin, see utils::matchRoute.
+      RouteHandler handler;
+    };
+
+    struct CachedFile {
+      std::uintmax_t size{0};
+      std::filesystem::file_time_type modified;
+      ResourceContent content;
+    };
+
+    struct DecodedMessage {
+      json::Invocation invocation;
+      std::shared_ptr<utils::SerialQueue> queue;
+      bool internal{false};
+    };
+
     void applySchemeOptions(const WebviewOptions& options);
+    void applyMessageOptions(const WebviewOptions& options);
+    void applyResourceOptions(const WebviewOptions& options);
+    void replaceLayer(const std::string& name, std::optional<ResourceLayer> layer,
+                      bool served = false);
+    void interceptResources();  // Starts answering requests to the origin, platform specific.
+    void stopInterceptingResources();
+    [[nodiscard]] std::optional<std::string_view> requestPath(std::string_view url) const;
+    [[nodiscard]] std::optional<ResourceResponse> respondToResource(const ResourceRequest& request,
+                                                                    const ResourcePack& pack);
+    [[nodiscard]] std::string preloadLinks(const ResourcePack& pack, std::string_view page) const;
+    // Disk layers answering with a streamed file set writeBody to the task writing it, to run
+    // once the response is handed over.
+    [[nodiscard]] std::optional<ResourceResponse> respondFromLayers(const ResourceRequest& request,
+                                                                    const ResourceLayers& layers,
+                                                                    std::size_t first,
+                                                                    utils::Task& writeBody);
+    [[nodiscard]] std::optional<ResourceResponse> respondToFile(const ResourceRequest& request,
+                                                                std::filesystem::path file,
+                                                                utils::Task& writeBody);
+    bool handleRoute(ResourceRequest& request, ResourceResponder& respond);
+    void recordResourceRequest(const std::string& url,
+                               std::chrono::steady_clock::time_point started,
+                               const std::optional<ResourceResponse>& response);
+    utils::WorkerPool& resourceWorkers();
+    void stopResourceWorkers();  // Called first by the destructor of every platform.
+    void replaceCallbacksScript(const std::string& script);
+    [[nodiscard]] DecodedMessage decodeMessage(const std::string& message) const;
+    void dispatchMessage(const std::string& message);
+    void acknowledgeMessage();
+    void onBridgeControl(bool delivered, std::size_t dropped);
+    void flushOutgoing();
 
     std::unique_ptr<Platform> platform_{nullptr};
     std::string name_;
-    std::unordered_map<std::string, MessageCallback> callbacks_;
+    mutable std::shared_mutex callbacksMutex_;
+    std::unordered_map<std::string, Callback> callbacks_;
+    std::map<std::string, std::string> callbackScripts_;
     AppHandler* appHandler_{nullptr};
-    Resources resources_;
+    // Topmost first, then the pack of loadResources and the served directories, longest path
+    // first. Copied on write and swapped with std::atomic_store, requests hold the layers they
+    // started with.
+    std::shared_ptr<const ResourceLayers> layers_;
+    std::mutex decodedResourcesMutex_;
+    // Keyed by the stored bytes, so swapping a layer leaves the contents of the others.
+    std::unique_ptr<utils::LruCache<const std::uint8_t*, DecodedContent>> decodedResources_;
+    std::vector<Route> routes_;  // In the order they were added.
+    std::mutex cachedFilesMutex_;
+    std::unique_ptr<utils::LruCache<std::string, CachedFile>> cachedFiles_;
+    mutable std::mutex resourceStatsMutex_;
+    ResourceStats resourceStats_;
+    std::chrono::milliseconds slowResourceThreshold_{0};  // Zero: slow requests are not reported.
     EventBus events_;
     mutable std::mutex readyMutex_;
     bool isReady_ = false;
     std::vector<std::function<void()>> readyCallbacks_;
     std::string protocol_;
     std::string origin_;
+
+    // Bounded bridge queues, see WebviewOptions::kOutgoingQueueCapacity and
+    // WebviewOptions::kIncomingQueueCapacity.
+    std::unique_ptr<utils::BoundedQueue<std::string>> outgoing_;
+    std::size_t incomingCapacity_{0};
+    QueuePolicy incomingPolicy_{QueuePolicy::kDropOldest};
+    std::atomic<std::size_t> incomingDropped_{0};
+    std::atomic<std::size_t> pendingAcks_{0};
+
+    // Background message dispatch, see WebviewOptions::kMessageWorkerThreads. The worker pools
+    // are declared last so their threads are joined before any other member is destroyed.
+    std::atomic<std::size_t> queuedMessages_{0};
+    std::shared_ptr<utils::SerialQueue> messageQueue_;
+    std::unique_ptr<utils::WorkerPool> messageWorkers_;
+
+    // Disk reads of the directories given to serveDirectory and route handlers, see
+    // WebviewOptions::kResourceWorkerThreads. Created with the first mount or route.
+    std::size_t resourceWorkerThreads_{0};
+    std::unique_ptr<utils::WorkerPool> resourceWorkers_;
+    // Bodies the handlers of the routes and the streamed files write while the page reads them.
+    std::shared_ptr<utils::ChunkedBodies> streams_{std::make_shared<utils::ChunkedBodies>()};
+  };
+
+  /**
+   * State shared by the copies of a RouteResponse. Platforms that stream get the response as soon
+   * as the handler writes, the others once it ends.
+   */
+  struct RouteResponse::State {
+    State(Webview::Impl::ResourceResponder respond, AppHandler* appHandler,
+          std::shared_ptr<utils::ChunkedBodies> streams);
+    ~State();
+
+    bool send(std::string_view chunk, bool last);
+    void fail();  // The handler threw: 500 if nothing was sent yet.
+    void complete();  // Hands the response to the main thread, requires the mutex.
+
+    std::mutex mutex;
+    Webview::Impl::ResourceResponse response;
+    Webview::Impl::ResourceResponder respond;
+    AppHandler* appHandler;
+    std::string buffered;  // Body of platforms that do not stream.
+    std::shared_ptr<utils::ChunkedBodies> streams;  // Null on platforms that do not stream.
+    bool committed{false};
+    bool ended{false};
   };
 
 }  // namespace deskgui
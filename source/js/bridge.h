@@ -0,0 +1,120 @@
+/**
+ * deskgui - A powerful and flexible C++ library to create web-based desktop applications.
+ *
+ * Copyright (c) 2023 deskgui
+ * MIT License
+ */
+
+#pragma once
+
+#include <deskgui/types.h>
+
+#include <cstddef>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace deskgui::js {
+  // Key of the messages the bridge sends about its own queues: [delivered, dropped].
+  static constexpr auto kBridgeControlKey = "__deskgui_bridge";
+
+  /**
+   * Creates the window.webview bridge.
+   *
+   * @param transport Body of a function sending `message` to the native side.
+   * @param capacity Messages the page may have in flight before queueing them, 0 to disable.
+   * @param policy Policy of the page side queue once it holds `capacity` messages.
+   * @param outgoingQueue Whether native messages are delivered in acknowledged batches.
+   */
+  inline std::string createBridge(std::string_view transport, std::size_t capacity,
+                                  QueuePolicy policy, bool outgoingQueue) {
+    const auto policyName = policy == QueuePolicy::kBlock      ? "block"
+                            : policy == QueuePolicy::kCoalesce ? "coalesce"
+                                                               : "drop-oldest";
+    std::stringstream ss;
+    ss << "window.webview = (() => {";
+    ss << "  const send = (message) => {" << transport << "};";
+    ss << "  const capacity = " << capacity << ";";
+    ss << "  const policy = '" << policyName << "';";
+    ss << "  const pending = [];";
+    ss << "  let inFlight = 0;";
+    ss << "  let dropped = 0;";
+
+    // Control messages bypass the queue so they never wait for credit.
+    ss << "  const control = (delivered) => {";
+    ss << "    send({ key: '" << kBridgeControlKey << "', payload: [delivered, dropped] });";
+    ss << "    dropped = 0;";
+    ss << "  };";
+
+    ss << "  const pump = () => {";
+    ss << "    while (pending.length > 0 && inFlight < capacity) {";
+    ss << "      const entry = pending.shift();";
+    ss << "      inFlight++;";
+    ss << "      entry.resolve(send(entry.message));";
+    ss << "    }";
+    ss << "  };";
+
+    // Dropped messages resolve with undefined, as the transport does when it is unavailable.
+    // Under the block policy at most `capacity` messages wait for credit, further ones are
+    // rejected so the page side queue stays bounded too.
+    ss << "  const bridge = {";
+    ss << "    async postMessage(message) {";
+    ss << "      if (capacity === 0) return send(message);";
+    ss << "      return new Promise((resolve, reject) => {";
+    ss << "        const key = message?.key;";
+    ss << "        if (policy === 'coalesce' && key !== undefined) {";
+    ss << "          const queued = pending.find((entry) => entry.message?.key === key);";
+    ss << "          if (queued) {";
+    ss << "            queued.resolve();";
+    ss << "            queued.message = message;";
+    ss << "            queued.resolve = resolve;";
+    ss << "            dropped++;";
+    ss << "            return;";
+    ss << "          }";
+    ss << "        }";
+    ss << "        if (pending.length >= capacity) {";
+    ss << "          if (policy === 'block') {";
+    ss << "            reject(new Error('webview message queue is full'));";
+    ss << "            return;";
+    ss << "          }";
+    ss << "          pending.shift().resolve();";
+    ss << "          dropped++;";
+    ss << "        }";
+    ss << "        pending.push({ message, resolve });";
+    ss << "        pump();";
+    ss << "      });";
+    ss << "    },";
+    ss << "    __ack(count) {";
+    ss << "      inFlight = Math.max(0, inFlight - count);";
+    ss << "      pump();";
+    ss << "      if (dropped > 0) control(false);";
+    ss << "    },";
+    ss << "    __delivered() { control(true); },";
+    ss << "  };";
+
+    // A new document never acknowledges the batches sent to the previous one.
+    if (outgoingQueue) {
+      ss << "  setTimeout(() => control(true));";
+    }
+
+    ss << "  return bridge;";
+    ss << "})();";
+
+    return ss.str();
+  }
+
+  /**
+   * Script delivering a batch of messages to window.webview.onMessage and acknowledging it.
+   */
+  inline std::string createDeliveryScript(const std::vector<std::string>& messages) {
+    std::stringstream ss;
+    for (const auto& message : messages) {
+      ss << "try { window.webview.onMessage('" << message << "'); }";
+      ss << " catch (error) { console.error(error); }";
+    }
+    ss << "window.webview.__delivered();";
+    return ss.str();
+  }
+
+}  // namespace deskgui::js
@@ -0,0 +1,163 @@
+/**
+ * deskgui - A powerful and flexible C++ library to create web-based desktop applications.
+ *
+ * Copyright (c) 2023 deskgui
+ * MIT License
+ */
+
+#include <deskgui/json.h>
+#include <rapidjson/memorystream.h>
+#include <rapidjson/reader.h>
+#include <rapidjson/stringbuffer.h>
+#include <rapidjson/writer.h>
+
+using namespace deskgui;
+
+namespace {
+
+  /**
+   * Pulls SAX events out of rapidjson's iterative parser, one token per call to next().
+   */
+  class StreamTokenReader final : public json::TokenReader {
+  public:
+    explicit StreamTokenReader(std::string_view text) : stream_(text.data(), text.size()) {
+      reader_.IterativeParseInit();
+    }
+
+    bool next(json::Token& token) override {
+      if (reader_.IterativeParseComplete()) return false;
+      token_ = &token;
+      return reader_.IterativeParseNext<rapidjson::kParseDefaultFlags>(stream_, *this);
+    }
+
+    [[nodiscard]] bool failed() const { return reader_.HasParseError(); }
+
+    // rapidjson handler concept
+    bool Null() { return emit(json::TokenType::kNull); }
+    bool Bool(bool value) {
+      token_->boolean = value;
+      return emit(json::TokenType::kBool);
+    }
+    bool Int(int value) { return Int64(value); }
+    bool Uint(unsigned value) { return Uint64(value); }
+    bool Int64(std::int64_t value) {
+      token_->integer = value;
+      return emit(json::TokenType::kInt);
+    }
+    bool Uint64(std::uint64_t value) {
+      token_->unsignedInteger = value;
+      return emit(json::TokenType::kUint);
+    }
+    bool Double(double value) {
+      token_->number = value;
+      return emit(json::TokenType::kDouble);
+    }
+    bool RawNumber(const char* str, rapidjson::SizeType length, bool copy) {
+      return String(str, length, copy);
+    }
+    bool String(const char* str, rapidjson::SizeType length, [[maybe_unused]] bool copy) {
+      // The parser reuses its internal buffer once the callback returns.
+      buffer_.assign(str, length);
+      token_->string = buffer_;
+      return emit(json::TokenType::kString);
+    }
+    bool Key(const char* str, rapidjson::SizeType length, bool copy) {
+      String(str, length, copy);
+      return emit(json::TokenType::kKey);
+    }
+    bool StartObject() { return emit(json::TokenType::kStartObject); }
+    bool EndObject([[maybe_unused]] rapidjson::SizeType memberCount) {
+      return emit(json::TokenType::kEndObject);
+    }
+    bool StartArray() { return emit(json::TokenType::kStartArray); }
+    bool EndArray([[maybe_unused]] rapidjson::SizeType elementCount) {
+      return emit(json::TokenType::kEndArray);
+    }
+
+  private:
+    bool emit(json::TokenType type) {
+      token_->type = type;
+      return true;
+    }
+
+    rapidjson::MemoryStream stream_;
+    rapidjson::Reader reader_;
+    json::Token* token_{nullptr};
+    std::string buffer_;
+  };
+
+  template <typename Writer> void write(Writer& writer, const json::Token& token) {
+    switch (token.type) {
+      case json::TokenType::kNull:
+        writer.Null();
+        break;
+      case json::TokenType::kBool:
+        writer.Bool(token.boolean);
+        break;
+      case json::TokenType::kInt:
+        writer.Int64(token.integer);
+        break;
+      case json::TokenType::kUint:
+        writer.Uint64(token.unsignedInteger);
+        break;
+      case json::TokenType::kDouble:
+        writer.Double(token.number);
+        break;
+      case json::TokenType::kString:
+        writer.String(token.string.data(), static_cast<rapidjson::SizeType>(token.string.size()));
+        break;
+      case json::TokenType::kKey:
+        writer.Key(token.string.data(), static_cast<rapidjson::SizeType>(token.string.size()));
+        break;
+      case json::TokenType::kStartObject:
+        writer.StartObject();
+        break;
+      case json::TokenType::kEndObject:
+        writer.EndObject();
+        break;
+      case json::TokenType::kStartArray:
+        writer.StartArray();
+        break;
+      case json::TokenType::kEndArray:
+        writer.EndArray();
+        break;
+    }
+  }
+
+}  // namespace
+
+bool json::parse(std::string_view text, const std::function<bool(TokenReader&)>& consumer) {
+  StreamTokenReader reader(text);
+  if (!consumer(reader)) return false;
+  // The tokens the consumer left are parsed as well, input after the value is an error.
+  Token token;
+  while (reader.next(token)) {
+  }
+  return !reader.failed();
+}
+
+bool json::capture(TokenReader& reader, const Token& first, std::string& output) {
+  if (first.type == TokenType::kKey || first.type == TokenType::kEndObject
+      || first.type == TokenType::kEndArray) {
+    return false;
+  }
+
+  rapidjson::StringBuffer buffer;
+  rapidjson::Writer<rapidjson::StringBuffer> writer(buffer);
+
+  std::size_t depth = 0;
+  Token token = first;
+  while (true) {
+    write(writer, token);
+    if (token.type == TokenType::kStartObject || token.type == TokenType::kStartArray) {
+      ++depth;
+    } else if (token.type == TokenType::kEndObject || token.type == TokenType::kEndArray) {
+      --depth;
+    }
+    if (depth == 0) break;
+    if (!reader.next(token)) return false;
+  }
+
+  output.assign(buffer.GetString(), buffer.GetSize());
+  return true;
+}
@@ -5,6 +5,7 @@
  * MIT License
  */
 
+#include "js/bridge.h"
 #include "webview_platform_darwin.h"
 
 using namespace deskgui;
@@ -19,20 +20,31 @@ Impl::Impl(const std::string& name, AppHandler* appHandler, void* window,
   }
 
   applySchemeOptions(options);
+  applyMessageOptions(options);
+  applyResourceOptions(options);
 
   platform_->parentWindow = window;
   initialize(options);
 }
 
 Impl::~Impl() {
+  stopResourceWorkers();
   [platform_->webview stopLoading];
   [platform_->controller removeScriptMessageHandlerForName:kScriptMessageCallback];
   [platform_->webview removeFromSuperview];
 }
 
+void Impl::reparent(void* window) {
+  platform_->parentWindow = window;
+  [platform_->webview removeFromSuperview];
+  [platform_->webview setFrame:[(__bridge id)platform_->parentWindow frame]];
+  [(__bridge id)platform_->parentWindow addSubview:platform_->webview];
+}
+
 void Impl::initialize(const WebviewOptions& options) {
   // Create WKWebView configuration
   platform_->controller = [[WKUserContentController alloc] init];
+  platform_->userScripts = [NSMutableArray array];
   platform_->configuration = [[WKWebViewConfiguration alloc] init];
   platform_->configuration.userContentController = platform_->controller;
   platform_->preferences = [[WKPreferences alloc] init];
@@ -45,10 +57,18 @@ void Impl::initialize(const WebviewOptions& options) {
     platform_->configuration.websiteDataStore = [WKWebsiteDataStore nonPersistentDataStore];
   }
 
+  // Webviews of a context group share its data store, ephemeral groups a non-persistent one. The
+  // web process limit is left to WebKit.
+  const auto contextGroup = options.getOption<std::string>(WebviewOptions::kContextGroup);
+  if (!contextGroup.empty()) {
+    platform_->contextGroup = WebContextGroup::get(contextGroup, ephemeralSession);
+    platform_->configuration.processPool = platform_->contextGroup->processPool;
+    platform_->configuration.websiteDataStore = platform_->contextGroup->dataStore;
+  }
+
   // Set up navigation delegate and custom scheme handler
   NSString* schemeUri = [NSString stringWithUTF8String:protocol_.c_str()];
-  platform_->navigationDelegate = [[CustomNavigationDelegate alloc] initWithWebview:this
-                                                                          resources:&resources_];
+  platform_->navigationDelegate = [[CustomNavigationDelegate alloc] initWithWebview:this];
   [platform_->controller addScriptMessageHandler:platform_->navigationDelegate
                                             name:kScriptMessageCallback];
   [platform_->configuration setURLSchemeHandler:platform_->navigationDelegate
@@ -88,15 +108,12 @@ void Impl::initialize(const WebviewOptions& options) {
   [platform_->webview setUIDelegate:platform_->uiDelegate];
 
   // Inject JS bridge
-  injectScript(R"(
-              window.webview = {
-                  async postMessage(message)
-                  {
+  const auto transport = R"(
                     if (typeof webkit === 'undefined' || !webkit.messageHandlers?.messageHandler) return;
                     return webkit.messageHandlers.messageHandler.postMessage(message);
-                  }
-              };
-              )");
+              )";
+  injectScript(
+      js::createBridge(transport, incomingCapacity_, incomingPolicy_, outgoing_ != nullptr));
               
   show(true);
   notifyReady();
@@ -152,11 +169,12 @@ std::string Impl::getUrl() {
   return "";
 }
 
-void Impl::loadResources(Resources&& resources) { resources_ = std::move(resources); }
+// The scheme handler is set on the configuration, every request reaches the delegate.
+void Impl::interceptResources() {}
 
-void Impl::serveResource(const std::string& resourceUrl) { navigate(origin_ + resourceUrl); }
+void Impl::stopInterceptingResources() {}
 
-void Impl::clearResources() { resources_.clear(); }
+void Impl::serveResource(const std::string& resourceUrl) { navigate(origin_ + resourceUrl); }
 
 void Impl::loadHTMLString(const std::string& html) {
   [platform_->webview loadHTMLString:[NSString stringWithUTF8String:html.c_str()] baseURL:nil];
@@ -168,9 +186,51 @@ void Impl::injectScript(const std::string& script) {
                              injectionTime:WKUserScriptInjectionTimeAtDocumentStart
                           forMainFrameOnly:YES];
   [platform_->controller addUserScript:script1];
+  [platform_->userScripts addObject:script1];
+}
+
+void Impl::replaceCallbacksScript(const std::string& script) {
+  // WKUserContentController cannot remove a single script, so the others are added back.
+  [platform_->controller removeAllUserScripts];
+  for (WKUserScript* userScript in platform_->userScripts) {
+    [platform_->controller addUserScript:userScript];
+  }
+  platform_->callbacksScript = nil;
+  if (script.empty()) return;
+
+  platform_->callbacksScript =
+      [[WKUserScript alloc] initWithSource:[NSString stringWithUTF8String:script.c_str()]
+                             injectionTime:WKUserScriptInjectionTimeAtDocumentStart
+                          forMainFrameOnly:YES];
+  [platform_->controller addUserScript:platform_->callbacksScript];
 }
 
 void Impl::executeScript(const std::string& script) {
   [platform_->webview evaluateJavaScript:[NSString stringWithUTF8String:script.c_str()]
                        completionHandler:nil];
 }
+
+void Impl::evaluateScript(const std::string& script, ScriptCallback callback) {
+  [platform_->webview evaluateJavaScript:[NSString stringWithUTF8String:script.c_str()]
+                       completionHandler:^(id result, NSError* error) {
+                         if (error) {
+                           callback(false, [[error localizedDescription] UTF8String]);
+                           return;
+                         }
+                         // undefined has no JSON representation and is reported as null.
+                         if (!result) {
+                           callback(true, "null");
+                           return;
+                         }
+                         NSData* data =
+                             [NSJSONSerialization dataWithJSONObject:result
+                                                             options:NSJSONWritingFragmentsAllowed
+                                                               error:nil];
+                         if (!data) {
+                           callback(false, "Script result cannot be serialized");
+                           return;
+                         }
+                         callback(true, std::string(static_cast<const char*>(data.bytes),
+                                                    data.length));
+                       }];
+}
@@ -9,6 +9,8 @@
 
 #include <WebKit/WebKit.h>
 
+#include <memory>
+#include <string>
 #include <vector>
 
 #include "interfaces/webview_impl.h"
@@ -24,8 +26,7 @@
 @interface CustomNavigationDelegate
     : NSObject <WKNavigationDelegate, WKScriptMessageHandler, WKURLSchemeHandler>
 @property(nonatomic) BOOL contextMenuEnabled;
-- (instancetype)initWithWebview:(deskgui::Webview::Impl*)webview
-                      resources:(std::vector<deskgui::Resource>*)resources;
+- (instancetype)initWithWebview:(deskgui::Webview::Impl*)webview;
 @end
 
 /**
@@ -60,6 +61,18 @@ namespace deskgui {
 
   extern NSString* const kScriptMessageCallback;
 
+  /**
+   * Process pool and data store shared by the webviews of a context group, see
+   * WebviewOptions::kContextGroup. Released with the last webview of the group.
+   */
+  struct WebContextGroup {
+    // The group of a name and session kind, created with the first webview of the group.
+    static std::shared_ptr<WebContextGroup> get(const std::string& name, bool ephemeral);
+
+    WKProcessPool* processPool = nullptr;
+    WKWebsiteDataStore* dataStore = nullptr;
+  };
+
   /**
    * Implementation details for the Webview class.
    * Contains the native WebKit components used by the Webview.
@@ -72,6 +85,9 @@ namespace deskgui {
     WKWebViewConfiguration* configuration = nullptr;  ///< WebView configuration
     WKPreferences* preferences = nullptr;             ///< WebView preferences
     CustomNavigationDelegate* navigationDelegate = nullptr;  ///< Navigation delegate
+    NSMutableArray<WKUserScript*>* userScripts = nullptr;    ///< Scripts added by injectScript
+    WKUserScript* callbacksScript = nullptr;                 ///< Script exposing the callbacks
+    std::shared_ptr<WebContextGroup> contextGroup;  ///< Null outside a context group
   };
 
 }  // namespace deskgui
@@ -7,6 +7,10 @@
 
 #include "webview_platform_darwin.h"
 
+#include <map>
+#include <unordered_map>
+#include <utility>
+
 #include "js/drop.h"
 
 using namespace deskgui;
@@ -16,15 +20,16 @@ NSString* const deskgui::kScriptMessageCallback = @"messageHandler";
 
 @implementation CustomNavigationDelegate {
   deskgui::Webview::Impl* webview_;
-  std::vector<deskgui::Resource>* resources_;
+  NSMutableSet<id<WKURLSchemeTask>>* activeTasks_;  // Tasks WebKit has not stopped yet
+  // Bodies of the tasks being streamed, cancelled when WebKit stops their task.
+  std::unordered_map<void*, std::shared_ptr<deskgui::utils::ChunkedBody>> streams_;
 }
 
-- (instancetype)initWithWebview:(deskgui::Webview::Impl*)webview
-                      resources:(std::vector<deskgui::Resource>*)resources {
+- (instancetype)initWithWebview:(deskgui::Webview::Impl*)webview {
   self = [super init];
   if (self) {
     webview_ = webview;
-    resources_ = resources;
+    activeTasks_ = [NSMutableSet set];
   }
   return self;
 }
@@ -33,8 +38,9 @@ NSString* const deskgui::kScriptMessageCallback = @"messageHandler";
       didReceiveScriptMessage:(nonnull WKScriptMessage*)message {
   if ([[message name] isEqualToString:kScriptMessageCallback]) {
     NSDictionary* dict = (NSDictionary*)message.body;
+    // Sorted keys put "key" before "payload", so the payload can be dispatched in a single pass.
     NSData* data = [NSJSONSerialization dataWithJSONObject:dict
-                                                   options:NSJSONWritingPrettyPrinted
+                                                   options:NSJSONWritingSortedKeys
                                                      error:nil];
     NSString* jsonString = [[NSString alloc] initWithData:data encoding:NSUTF8StringEncoding];
     webview_->onMessage([jsonString UTF8String]);
@@ -81,42 +87,128 @@ NSString* const deskgui::kScriptMessageCallback = @"messageHandler";
 
 - (void)webView:(WKWebView*)webView startURLSchemeTask:(id<WKURLSchemeTask>)urlSchemeTask {
   NSString* schemeUri = [NSString stringWithUTF8String:webview_->getProtocol().c_str()];
-  if ([urlSchemeTask.request.URL.scheme isEqualToString:schemeUri] && resources_ != nullptr) {
-    NSString* resourceURL = urlSchemeTask.request.URL.relativeString;
-    std::string resourceURLString = [resourceURL UTF8String];
-    std::string resourceScheme = resourceURLString.substr(webview_->getOrigin().size());
-
-    size_t secondLastDotPos = resourceScheme.rfind('.', resourceScheme.rfind('.') - 1);
-    if (secondLastDotPos != std::string::npos) {
-      resourceScheme = resourceScheme.substr(secondLastDotPos + 1);
-      size_t firstSlash = resourceScheme.find('/');
-      if (firstSlash != std::string::npos) {
-        resourceScheme = resourceScheme.substr(firstSlash + 1);
-      }
+  if ([urlSchemeTask.request.URL.scheme isEqualToString:schemeUri]) {
+    deskgui::Webview::Impl::ResourceRequest request{
+        [urlSchemeTask.request.URL.absoluteString UTF8String]};
+    if (NSString* range = [urlSchemeTask.request valueForHTTPHeaderField:@"Range"]) {
+      request.range = [range UTF8String];
     }
-
-    auto it = std::find_if(
-        resources_->begin(), resources_->end(),
-        [&](const deskgui::Resource& resource) { return resource.scheme == resourceScheme; });
-
-    if (it != resources_->end()) {
-      NSData* resourceData = [NSData dataWithBytes:it->content.data() length:it->content.size()];
-      NSString* mime = [NSString stringWithUTF8String:it->mime.c_str()];
-      NSURLResponse* response = [[NSURLResponse alloc] initWithURL:urlSchemeTask.request.URL
-                                                          MIMEType:mime
-                                             expectedContentLength:resourceData.length
-                                                  textEncodingName:nil];
-
-      [urlSchemeTask didReceiveResponse:response];
-      [urlSchemeTask didReceiveData:resourceData];
-      [urlSchemeTask didFinish];
+    if (NSString* tag = [urlSchemeTask.request valueForHTTPHeaderField:@"If-None-Match"]) {
+      request.ifNoneMatch = [tag UTF8String];
+    }
+    if (NSString* method = urlSchemeTask.request.HTTPMethod) {
+      request.method = [method UTF8String];
     }
+    if (NSData* body = urlSchemeTask.request.HTTPBody) {
+      request.body.assign(static_cast<const char*>(body.bytes), body.length);
+    }
+
+    // Files served from disk complete later, WebKit throws if a stopped task is answered.
+    [activeTasks_ addObject:urlSchemeTask];
+    webview_->handleResourceRequest(
+        std::move(request),
+        [self, urlSchemeTask](
+            std::optional<deskgui::Webview::Impl::ResourceResponse> resourceResponse) {
+          if (![self->activeTasks_ containsObject:urlSchemeTask]) {
+            if (resourceResponse && resourceResponse->stream) resourceResponse->stream->cancel();
+            return;
+          }
+          [self finishURLSchemeTask:urlSchemeTask withResponse:resourceResponse];
+        });
+  }
+}
+
+- (void)finishURLSchemeTask:(id<WKURLSchemeTask>)urlSchemeTask
+               withResponse:
+                   (const std::optional<deskgui::Webview::Impl::ResourceResponse>&)resourceResponse {
+  if (resourceResponse && resourceResponse->stream) {
+    [urlSchemeTask didReceiveResponse:[self responseOf:*resourceResponse
+                                                forURL:urlSchemeTask.request.URL]];
+    [self stream:resourceResponse->stream toTask:urlSchemeTask];
     return;
   }
+
+  [activeTasks_ removeObject:urlSchemeTask];
+  if (resourceResponse) {
+    // Static bytes are served in place; owned bytes stay alive until WebKit releases them.
+    const deskgui::ResourceContent& body = resourceResponse->body;
+    void* bytes = const_cast<std::uint8_t*>(body.data());
+    NSData* resourceData;
+    if (body.isStatic()) {
+      resourceData = [NSData dataWithBytesNoCopy:bytes length:body.size() freeWhenDone:NO];
+    } else {
+      std::shared_ptr<const void> owner = body.owner();
+      resourceData = [[NSData alloc] initWithBytesNoCopy:bytes
+                                                  length:body.size()
+                                             deallocator:^(void*, NSUInteger) {
+                                               (void)owner;
+                                             }];
+    }
+
+    [urlSchemeTask didReceiveResponse:[self responseOf:*resourceResponse
+                                                forURL:urlSchemeTask.request.URL]];
+    [urlSchemeTask didReceiveData:resourceData];
+    [urlSchemeTask didFinish];
+  } else {
+    [urlSchemeTask didFailWithError:[NSError errorWithDomain:NSURLErrorDomain
+                                                        code:NSURLErrorFileDoesNotExist
+                                                    userInfo:nil]];
+  }
+}
+
+- (NSHTTPURLResponse*)responseOf:(const deskgui::Webview::Impl::ResourceResponse&)resourceResponse
+                           forURL:(NSURL*)url {
+  // AVFoundation only seeks in media answered with 206 and Content-Range.
+  NSMutableDictionary<NSString*, NSString*>* headers = [NSMutableDictionary dictionary];
+  for (const auto& [name, value] : resourceResponse.headers) {
+    headers[[NSString stringWithUTF8String:name.c_str()]] =
+        [NSString stringWithUTF8String:value.c_str()];
+  }
+  return [[NSHTTPURLResponse alloc] initWithURL:url
+                                     statusCode:resourceResponse.status
+                                    HTTPVersion:@"HTTP/1.1"
+                                   headerFields:headers];
+}
+
+- (void)stream:(std::shared_ptr<deskgui::utils::ChunkedBody>)body
+        toTask:(id<WKURLSchemeTask>)urlSchemeTask {
+  streams_[(__bridge void*)urlSchemeTask] = body;
+
+  // The body is read off the main thread and each chunk is handed to WebKit on the main thread
+  // without waiting for it: the main thread may be joining the handler writing the body. A few
+  // chunks are in flight at most, which keeps the body pushing back on the handler. A cancelled
+  // body, because WebKit stopped the task or the webview is destroyed, reads empty and its
+  // pending chunks are dropped.
+  dispatch_semaphore_t inFlight = dispatch_semaphore_create(16);
+  dispatch_async(dispatch_get_global_queue(QOS_CLASS_USER_INITIATED, 0), ^{
+    std::vector<std::uint8_t> buffer(64 * 1024);
+    while (true) {
+      const std::size_t size = body->read(buffer.data(), buffer.size());
+      NSData* chunk = size ? [NSData dataWithBytes:buffer.data() length:size] : nil;
+      if (chunk) dispatch_semaphore_wait(inFlight, DISPATCH_TIME_FOREVER);
+      dispatch_async(dispatch_get_main_queue(), ^{
+        if (chunk) dispatch_semaphore_signal(inFlight);
+        if (body->cancelled() || ![self->activeTasks_ containsObject:urlSchemeTask]) return;
+        if (chunk) {
+          [urlSchemeTask didReceiveData:chunk];
+          return;
+        }
+        [self->activeTasks_ removeObject:urlSchemeTask];
+        self->streams_.erase((__bridge void*)urlSchemeTask);
+        [urlSchemeTask didFinish];
+      });
+      if (!chunk) return;
+    }
+  });
 }
 
 - (void)webView:(WKWebView*)webView stopURLSchemeTask:(id<WKURLSchemeTask>)urlSchemeTask {
-  // Todo
+  [activeTasks_ removeObject:urlSchemeTask];
+  auto stream = streams_.find((__bridge void*)urlSchemeTask);
+  if (stream != streams_.end()) {
+    stream->second->cancel();
+    streams_.erase(stream);
+  }
 }
 
 @end
@@ -257,3 +349,21 @@ NSString* const deskgui::kScriptMessageCallback = @"messageHandler";
 }
 
 @end
+
+std::shared_ptr<WebContextGroup> deskgui::WebContextGroup::get(const std::string& name,
+                                                               bool ephemeral) {
+  // Ephemeral and persistent webviews never share a data store, their groups are told apart.
+  static std::map<std::pair<std::string, bool>, std::weak_ptr<WebContextGroup>> groups;
+  const auto key = std::make_pair(name, ephemeral);
+  if (auto found = groups.find(key); found != groups.end()) {
+    if (auto group = found->second.lock()) return group;
+    groups.erase(found);
+  }
+
+  auto group = std::make_shared<WebContextGroup>();
+  group->processPool = [[WKProcessPool alloc] init];
+  group->dataStore = ephemeral ? [WKWebsiteDataStore nonPersistentDataStore]
+                               : [WKWebsiteDataStore defaultDataStore];
+  groups.emplace(key, group);
+  return group;
+}
@@ -5,6 +5,7 @@
  * MIT License
  */
 
+#include "js/bridge.h"
 #include "webview_platform_linux.h"
 
 using namespace deskgui;
@@ -19,37 +20,78 @@ Impl::Impl(const std::string& name, AppHandler* appHandler, void* window,
   }
 
   applySchemeOptions(options);
+  applyMessageOptions(options);
+  applyResourceOptions(options);
 
   // Create GTK container hierarchy
   GtkWindow* parentWindow = GTK_WINDOW(window);
-  GtkScrolledWindow* scrolledWindow = GTK_SCROLLED_WINDOW(gtk_scrolled_window_new(NULL, NULL));
-  gtk_container_add(GTK_CONTAINER(parentWindow), GTK_WIDGET(scrolledWindow));
+  platform_->scrolledWindow = GTK_SCROLLED_WINDOW(gtk_scrolled_window_new(NULL, NULL));
+  gtk_container_add(GTK_CONTAINER(parentWindow), GTK_WIDGET(platform_->scrolledWindow));
   platform_->container = GTK_FIXED(gtk_fixed_new());
-  gtk_container_add(GTK_CONTAINER(scrolledWindow), GTK_WIDGET(platform_->container));
+  gtk_container_add(GTK_CONTAINER(platform_->scrolledWindow), GTK_WIDGET(platform_->container));
 
   initialize(options);
 }
 
 Impl::~Impl() {
+  stopResourceWorkers();
+  if (platform_->callbacksScript) {
+    webkit_user_script_unref(platform_->callbacksScript);
+  }
+  // The widget belongs to the window and may outlive the webview, it stops pointing to it.
+  if (platform_->webview) {
+    g_object_weak_unref(G_OBJECT(platform_->webview), platform_->onWebviewFinalized,
+                        platform_.get());
+    g_object_set_data(G_OBJECT(platform_->webview), Platform::kImplKey, nullptr);
+    platform_->forgetWebview();
+  }
+  platform_->scrolledWindow = nullptr;
   platform_->container = nullptr;
   platform_->webview = nullptr;
 }
 
+void Impl::reparent(void* window) {
+  // The hierarchy is kept alive while it has no parent, the web process is not restarted.
+  GtkWidget* root = GTK_WIDGET(platform_->scrolledWindow);
+  g_object_ref(root);
+  gtk_container_remove(GTK_CONTAINER(gtk_widget_get_parent(root)), root);
+  gtk_container_add(GTK_CONTAINER(window), root);
+  g_object_unref(root);
+  gtk_widget_show_all(root);
+}
+
 void Impl::initialize(const WebviewOptions& options) {
-  // Create webview (with ephemeral context if requested)
+  // Create webview in the context of its group (ephemeral if requested)
   const bool ephemeralSession = options.hasOption(WebviewOptions::kEphemeralSession)
       && options.getOption<bool>(WebviewOptions::kEphemeralSession);
-  if (ephemeralSession) {
-    WebKitWebContext* ephemeralContext = webkit_web_context_new_ephemeral();
-    platform_->webview = WEBKIT_WEB_VIEW(webkit_web_view_new_with_context(ephemeralContext));
-    g_object_unref(ephemeralContext);
+  platform_->contextGroup = WebContextGroup::get(
+      options.getOption<std::string>(WebviewOptions::kContextGroup), ephemeralSession);
+  auto& group = *platform_->contextGroup;
+
+  // Past the process limit of the group, webviews share the web process of an existing one.
+  const int processLimit = options.getOption<int>(WebviewOptions::kWebProcessLimit);
+  WebKitWebView* relatedView = nullptr;
+  if (processLimit > 0 && group.processOwners.size() >= static_cast<std::size_t>(processLimit)) {
+    relatedView = group.processOwners[group.nextRelated++ % group.processOwners.size()];
+  }
+  WebKitUserContentManager* userContentManager = webkit_user_content_manager_new();
+  if (relatedView) {
+    platform_->webview = WEBKIT_WEB_VIEW(g_object_new(WEBKIT_TYPE_WEB_VIEW, "related-view",
+                                                      relatedView, "user-content-manager",
+                                                      userContentManager, nullptr));
   } else {
-    platform_->webview = WEBKIT_WEB_VIEW(webkit_web_view_new());
+    platform_->webview = WEBKIT_WEB_VIEW(g_object_new(WEBKIT_TYPE_WEB_VIEW, "web-context",
+                                                      group.context, "user-content-manager",
+                                                      userContentManager, nullptr));
   }
+  g_object_unref(userContentManager);
 
   if (!platform_->webview) {
     throw std::runtime_error("Failed to create webview.");
   }
+  if (!relatedView) group.processOwners.push_back(platform_->webview);
+  g_object_set_data(G_OBJECT(platform_->webview), Platform::kImplKey, this);
+  g_object_weak_ref(G_OBJECT(platform_->webview), platform_->onWebviewFinalized, platform_.get());
 
   // Set initial position and size
   gtk_fixed_put(platform_->container, GTK_WIDGET(platform_->webview), kDefaultWindowRect.L,
@@ -74,22 +116,23 @@ void Impl::initialize(const WebviewOptions& options) {
   g_signal_connect(contentManager, "script-message-received::messageHandler",
                    G_CALLBACK(platform_->onScriptMessageReceived), this);
 
-  // Register custom URI scheme for local resources
-  WebKitWebContext* context = webkit_web_view_get_context(platform_->webview);
-  webkit_web_context_register_uri_scheme(
-      context, protocol_.c_str(), (WebKitURISchemeRequestCallback)platform_->onCustomSchemeRequest,
-      this, NULL);
+  // Register custom URI scheme for local resources, once per context
+  if (group.schemes.insert(protocol_).second) {
+    webkit_web_context_register_uri_scheme(
+        group.context, protocol_.c_str(),
+        (WebKitURISchemeRequestCallback)platform_->onCustomSchemeRequest, nullptr, NULL);
+    // fetch() only reaches custom schemes registered as CORS enabled, such as the routes.
+    webkit_security_manager_register_uri_scheme_as_cors_enabled(
+        webkit_web_context_get_security_manager(group.context), protocol_.c_str());
+  }
 
   // Inject JS bridge
-  injectScript(R"(
-                window.webview = {
-                    async postMessage(message) 
-                    {
+  const auto transport = R"(
                       if (typeof window.webkit === 'undefined' || !window.webkit.messageHandlers?.messageHandler) return;
                       return window.webkit.messageHandlers.messageHandler.postMessage(JSON.stringify(message));
-                    }
-                };
-                )");
+                )";
+  injectScript(
+      js::createBridge(transport, incomingCapacity_, incomingPolicy_, outgoing_ != nullptr));
 
   show(true);
   notifyReady();
@@ -142,11 +185,12 @@ void Impl::loadHTMLString(const std::string& html) {
   webkit_web_view_load_html(platform_->webview, html.c_str(), NULL);
 }
 
-void Impl::loadResources(Resources&& resources) { resources_ = std::move(resources); }
+// The custom scheme is registered with the web context, every request reaches the handler.
+void Impl::interceptResources() {}
 
-void Impl::serveResource(const std::string& resourceUrl) { navigate(origin_ + resourceUrl); }
+void Impl::stopInterceptingResources() {}
 
-void Impl::clearResources() { resources_.clear(); }
+void Impl::serveResource(const std::string& resourceUrl) { navigate(origin_ + resourceUrl); }
 
 std::string Impl::getUrl() {
   const gchar* uri = webkit_web_view_get_uri(platform_->webview);
@@ -164,3 +208,24 @@ void Impl::injectScript(const std::string& script) {
 void Impl::executeScript(const std::string& script) {
   webkit_web_view_run_javascript(platform_->webview, script.c_str(), nullptr, nullptr, nullptr);
 }
+
+void Impl::replaceCallbacksScript(const std::string& script) {
+  WebKitUserContentManager* manager = webkit_web_view_get_user_content_manager(platform_->webview);
+  if (platform_->callbacksScript) {
+    webkit_user_content_manager_remove_script(manager, platform_->callbacksScript);
+    webkit_user_script_unref(platform_->callbacksScript);
+    platform_->callbacksScript = nullptr;
+  }
+  if (script.empty()) return;
+
+  platform_->callbacksScript
+      = webkit_user_script_new(script.c_str(), WEBKIT_USER_CONTENT_INJECT_TOP_FRAME,
+                               WEBKIT_USER_SCRIPT_INJECT_AT_DOCUMENT_START, nullptr, nullptr);
+  webkit_user_content_manager_add_script(manager, platform_->callbacksScript);
+}
+
+void Impl::evaluateScript(const std::string& script, ScriptCallback callback) {
+  webkit_web_view_run_javascript(platform_->webview, script.c_str(), nullptr,
+                                 platform_->onScriptEvaluated,
+                                 new ScriptCallback(std::move(callback)));
+}
@@ -7,6 +7,90 @@
 
 #include "webview_platform_linux.h"
 
+namespace {
+  using namespace deskgui;
+
+  /*
+   * GInputStream reading a ChunkedBody. The stream is not pollable, so GIO runs the blocking
+   * reads WebKit starts on its worker threads.
+   */
+  struct ChunkedInputStream {
+    GInputStream parent;
+    std::shared_ptr<utils::ChunkedBody>* body;
+  };
+
+  struct ChunkedInputStreamClass {
+    GInputStreamClass parent;
+  };
+
+  G_DEFINE_TYPE(ChunkedInputStream, chunked_input_stream, G_TYPE_INPUT_STREAM)
+
+  void cancelChunkedBody(GCancellable*, gpointer body) {
+    static_cast<utils::ChunkedBody*>(body)->cancel();
+  }
+
+  gssize chunked_input_stream_read(GInputStream* stream, void* buffer, gsize count,
+                                   GCancellable* cancellable, GError** error) {
+    auto& body = *reinterpret_cast<ChunkedInputStream*>(stream)->body;
+    // A cancelled load wakes the read waiting for the route handler.
+    const gulong handler
+        = cancellable ? g_cancellable_connect(cancellable, G_CALLBACK(cancelChunkedBody),
+                                              body.get(), nullptr)
+                      : 0;
+    const auto size = body->read(static_cast<std::uint8_t*>(buffer), count);
+    g_cancellable_disconnect(cancellable, handler);
+    if (g_cancellable_set_error_if_cancelled(cancellable, error)) return -1;
+    return static_cast<gssize>(size);
+  }
+
+  // The reader is done, a handler still writing is told to stop.
+  gboolean chunked_input_stream_close(GInputStream* stream, GCancellable*, GError**) {
+    (*reinterpret_cast<ChunkedInputStream*>(stream)->body)->cancel();
+    return TRUE;
+  }
+
+  void chunked_input_stream_finalize(GObject* object) {
+    delete reinterpret_cast<ChunkedInputStream*>(object)->body;
+    G_OBJECT_CLASS(chunked_input_stream_parent_class)->finalize(object);
+  }
+
+  void chunked_input_stream_class_init(ChunkedInputStreamClass* streamClass) {
+    G_OBJECT_CLASS(streamClass)->finalize = chunked_input_stream_finalize;
+    G_INPUT_STREAM_CLASS(streamClass)->read_fn = chunked_input_stream_read;
+    G_INPUT_STREAM_CLASS(streamClass)->close_fn = chunked_input_stream_close;
+  }
+
+  void chunked_input_stream_init(ChunkedInputStream* stream) {
+    stream->body = new std::shared_ptr<utils::ChunkedBody>();
+  }
+
+  // Stream of a response body. Returns nullptr if the body cannot be wrapped.
+  GInputStream* responseStream(const Webview::Impl::ResourceResponse& response) {
+    if (response.stream) {
+      auto* stream = static_cast<ChunkedInputStream*>(
+          g_object_new(chunked_input_stream_get_type(), nullptr));
+      *stream->body = response.stream;
+      return G_INPUT_STREAM(stream);
+    }
+
+    // Static bytes are served in place; owned bytes stay alive until WebKit releases them.
+    // The stream reads the requested slice in place, mapped archives are paged in on demand.
+    const ResourceContent& body = response.body;
+    GBytes* bytes
+        = body.isStatic()
+              ? g_bytes_new_static(body.data(), body.size())
+              : g_bytes_new_with_free_func(
+                  body.data(), body.size(),
+                  [](gpointer owner) { delete static_cast<std::shared_ptr<const void>*>(owner); },
+                  new std::shared_ptr<const void>(body.owner()));
+    if (!bytes) return nullptr;
+
+    GInputStream* stream = g_memory_input_stream_new_from_bytes(bytes);
+    g_bytes_unref(bytes);
+    return stream;
+  }
+}  // namespace
+
 namespace deskgui {
 
   using Platform = Webview::Impl::Platform;
@@ -60,43 +144,142 @@ namespace deskgui {
     g_free(s);
   }
 
-  void Platform::onCustomSchemeRequest(WebKitURISchemeRequest* request, gpointer userData) {
-    Webview::Impl* impl = static_cast<Webview::Impl*>(userData);
+  void Platform::onScriptEvaluated(GObject* object, GAsyncResult* result, gpointer userData) {
+    std::unique_ptr<ScriptCallback> callback(static_cast<ScriptCallback*>(userData));
 
-    if (!impl || !request) return;
+    GError* error = nullptr;
+    WebKitJavascriptResult* scriptResult
+        = webkit_web_view_run_javascript_finish(WEBKIT_WEB_VIEW(object), result, &error);
+    if (!scriptResult) {
+      std::string message = error ? error->message : "Script evaluation failed";
+      g_clear_error(&error);
+      (*callback)(false, message);
+      return;
+    }
 
-    const gchar* uri = webkit_uri_scheme_request_get_uri(request);
+    // undefined has no JSON representation and is reported as null.
+    JSCValue* value = webkit_javascript_result_get_js_value(scriptResult);
+    gchar* json = jsc_value_to_json(value, 0);
+    (*callback)(true, json ? json : "null");
+    g_free(json);
+    webkit_javascript_result_unref(scriptResult);
+  }
 
-    auto it = std::find_if(impl->resources_.begin(), impl->resources_.end(),
-                           [&](const Resource& resource) {
-                             return (impl->getOrigin() + resource.scheme) == std::string(uri);
-                           });
+  std::shared_ptr<WebContextGroup> WebContextGroup::get(const std::string& name, bool ephemeral) {
+    // Ephemeral webviews outside a group keep their own context, nothing they store is shared.
+    // Ephemeral and persistent webviews never share a context, their groups are told apart.
+    static std::map<std::pair<std::string, bool>, std::weak_ptr<WebContextGroup>> groups;
+    const bool shared = !name.empty() || !ephemeral;
+    const auto key = std::make_pair(name, ephemeral);
+    if (shared) {
+      if (auto found = groups.find(key); found != groups.end()) {
+        if (auto group = found->second.lock()) return group;
+        groups.erase(found);
+      }
+    }
 
-    if (it != impl->resources_.end()) {
-      GBytes* bytes = g_bytes_new(it->content.data(), it->content.size());
+    WebKitWebContext* context = nullptr;
+    if (ephemeral) {
+      context = webkit_web_context_new_ephemeral();
+    } else if (name.empty()) {
+      context = WEBKIT_WEB_CONTEXT(g_object_ref(webkit_web_context_get_default()));
+    } else {
+      context = webkit_web_context_new();
+    }
+    auto group = std::make_shared<WebContextGroup>(context);
+    if (shared) groups.emplace(key, group);
+    return group;
+  }
 
-      if (!bytes) {
-        GError* error = nullptr;
-        g_set_error(&error, g_quark_from_static_string("webview"), 1,
-                    "Requested resource for webview is not supported");
-        webkit_uri_scheme_request_finish_error(request, error);
-        g_clear_error(&error);
-        return;
+  void Platform::onWebviewFinalized(gpointer userData, [[maybe_unused]] GObject* webview) {
+    auto* platform = static_cast<Platform*>(userData);
+    platform->forgetWebview();
+    platform->webview = nullptr;
+  }
+
+  void Platform::forgetWebview() {
+    auto& owners = contextGroup->processOwners;
+    owners.erase(std::remove(owners.begin(), owners.end(), webview), owners.end());
+  }
+
+  void Platform::onCustomSchemeRequest(WebKitURISchemeRequest* request,
+                                       [[maybe_unused]] gpointer userData) {
+    // The scheme is registered once per context, the request tells its webview.
+    WebKitWebView* webview = webkit_uri_scheme_request_get_web_view(request);
+    auto* impl = webview
+                     ? static_cast<Webview::Impl*>(g_object_get_data(G_OBJECT(webview), kImplKey))
+                     : nullptr;
+    if (!impl) {
+      finishSchemeRequest(request, std::nullopt);
+      return;
+    }
+
+    Webview::Impl::ResourceRequest resourceRequest{webkit_uri_scheme_request_get_uri(request)};
+#if WEBKIT_CHECK_VERSION(2, 36, 0)
+    if (SoupMessageHeaders* headers = webkit_uri_scheme_request_get_http_headers(request)) {
+      const char* range = soup_message_headers_get_one(headers, "Range");
+      const char* ifNoneMatch = soup_message_headers_get_one(headers, "If-None-Match");
+      resourceRequest.range = range ? range : "";
+      resourceRequest.ifNoneMatch = ifNoneMatch ? ifNoneMatch : "";
+    }
+    if (const char* method = webkit_uri_scheme_request_get_http_method(request)) {
+      resourceRequest.method = method;
+    }
+#endif
+#if WEBKIT_CHECK_VERSION(2, 40, 0)
+    // Request bodies are held in memory by WebKit, reading them does not block.
+    if (GInputStream* body = webkit_uri_scheme_request_get_http_body(request)) {
+      char buffer[16 * 1024];
+      gssize read = 0;
+      while ((read = g_input_stream_read(body, buffer, sizeof(buffer), nullptr, nullptr)) > 0) {
+        resourceRequest.body.append(buffer, static_cast<std::size_t>(read));
       }
+      g_object_unref(body);
+    }
+#endif
 
-      GInputStream* inputStream = G_INPUT_STREAM(g_memory_input_stream_new_from_bytes(bytes));
+    // Files served from disk complete later, the request is kept alive until then.
+    g_object_ref(request);
+    impl->handleResourceRequest(
+        std::move(resourceRequest),
+        [request](std::optional<Webview::Impl::ResourceResponse> response) {
+          finishSchemeRequest(request, response);
+          g_object_unref(request);
+        });
+  }
 
-      webkit_uri_scheme_request_finish(request, inputStream, it->content.size(), it->mime.c_str());
-      g_object_unref(inputStream);
-      g_bytes_unref(bytes);
+  void Platform::finishSchemeRequest(
+      WebKitURISchemeRequest* request,
+      const std::optional<Webview::Impl::ResourceResponse>& response) {
+    GInputStream* inputStream = response ? responseStream(*response) : nullptr;
+    if (!inputStream) {
+      GError* error = nullptr;
+      g_set_error(&error, g_quark_from_static_string("webview"), 1,
+                  "Cannot load requested resource for webview");
+      webkit_uri_scheme_request_finish_error(request, error);
+      g_clear_error(&error);
       return;
     }
 
-    GError* error = nullptr;
-    g_set_error(&error, g_quark_from_static_string("webview"), 1,
-                "Cannot load requested resource for webview");
-    webkit_uri_scheme_request_finish_error(request, error);
-    g_clear_error(&error);
+    // Streamed bodies have no length, WebKit reads them until they end.
+    const gint64 size = response->stream ? -1 : static_cast<gint64>(response->body.size());
+#if WEBKIT_CHECK_VERSION(2, 36, 0)
+    WebKitURISchemeResponse* schemeResponse = webkit_uri_scheme_response_new(inputStream, size);
+    webkit_uri_scheme_response_set_status(schemeResponse, response->status,
+                                          response->reason.c_str());
+    webkit_uri_scheme_response_set_content_type(schemeResponse, response->mime.c_str());
+    SoupMessageHeaders* headers = soup_message_headers_new(SOUP_MESSAGE_HEADERS_RESPONSE);
+    for (const auto& [name, value] : response->headers) {
+      soup_message_headers_append(headers, name.c_str(), value.c_str());
+    }
+    webkit_uri_scheme_response_set_http_headers(schemeResponse, headers);
+    webkit_uri_scheme_request_finish_with_response(request, schemeResponse);
+    g_object_unref(schemeResponse);
+#else
+    // Older WebKitGTK cannot set a status, ranges are not served.
+    webkit_uri_scheme_request_finish(request, inputStream, size, response->mime.c_str());
+#endif
+    g_object_unref(inputStream);
   }
 
 }  // namespace deskgui
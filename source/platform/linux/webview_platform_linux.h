@@ -11,13 +11,45 @@
 #include <webkit2/webkit2.h>
 
 #include <algorithm>
+#include <map>
+#include <memory>
+#include <optional>
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
 
 #include "interfaces/webview_impl.h"
 
 namespace deskgui {
+  /**
+   * Web context shared by the webviews of a context group, see WebviewOptions::kContextGroup.
+   * Each custom scheme is registered once, requests find their webview through its widget.
+   */
+  struct WebContextGroup {
+    explicit WebContextGroup(WebKitWebContext* webContext) : context(webContext) {}
+    ~WebContextGroup() { g_object_unref(context); }
+
+    WebContextGroup(const WebContextGroup&) = delete;
+    WebContextGroup& operator=(const WebContextGroup&) = delete;
+
+    // The group of a name and session kind, created with the first webview of the group.
+    static std::shared_ptr<WebContextGroup> get(const std::string& name, bool ephemeral);
+
+    WebKitWebContext* context;
+    std::set<std::string> schemes;  // Registered custom schemes.
+    std::vector<WebKitWebView*> processOwners;  // Webviews not sharing the process of another.
+    std::size_t nextRelated{0};                 // Round robin over processOwners.
+  };
+
   struct Webview::Impl::Platform {
+    static constexpr auto kImplKey = "deskgui-webview";  // Data of the widget, the Impl.
+
+    std::shared_ptr<WebContextGroup> contextGroup;
     WebKitWebView* webview;
+    GtkScrolledWindow* scrolledWindow;  // Child of the window, holds the container.
     GtkFixed* container;
+    WebKitUserScript* callbacksScript = nullptr;
 
     static gboolean onNavigationRequest(WebKitWebView* webview, WebKitPolicyDecision* decision,
                                         WebKitPolicyDecisionType decisionType, Webview::Impl* impl);
@@ -26,5 +58,10 @@ namespace deskgui {
     static void onScriptMessageReceived(WebKitUserContentManager* manager,
                                         WebKitJavascriptResult* message, Webview::Impl* impl);
     static void onCustomSchemeRequest(WebKitURISchemeRequest* request, gpointer userData);
+    static void onWebviewFinalized(gpointer userData, GObject* webview);
+    void forgetWebview();  // Called once the widget is finalized or the webview destroyed.
+    static void finishSchemeRequest(WebKitURISchemeRequest* request,
+                                    const std::optional<Webview::Impl::ResourceResponse>& response);
+    static void onScriptEvaluated(GObject* object, GAsyncResult* result, gpointer userData);
   };
 }  // namespace deskgui
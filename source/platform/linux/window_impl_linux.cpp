@@ -42,6 +42,8 @@ Impl::Impl(const std::string& name, AppHandler* appHandler, void* nativeWindow)
 }
 
 Impl::~Impl() {
+  // The settings outlive the window, such as the hidden windows of the webview pool.
+  g_signal_handlers_disconnect_by_data(gtk_settings_get_default(), this);
   if (!isExternalWindow_ && platform_->window != nullptr) {
     gtk_widget_destroy(GTK_WIDGET(platform_->window));
     platform_->window = nullptr;
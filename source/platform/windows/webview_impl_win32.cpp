@@ -9,6 +9,7 @@
 
 #include <iostream>
 
+#include "js/bridge.h"
 #include "js/drop.h"
 #include "utils/strings.h"
 #include "webview_platform_win32.h"
@@ -28,6 +29,8 @@ Impl::Impl(const std::string& name, AppHandler* appHandler, void* window,
   }
 
   applySchemeOptions(options);
+  applyMessageOptions(options);
+  applyResourceOptions(options);
 
   platform_->webviewImpl_ = this;
   platform_->options_ = options;
@@ -147,15 +150,12 @@ void Impl::initialize(const WebviewOptions& options) {
       nullptr);
 
   // Inject JS bridge
-  injectScript(R"(
-                window.webview = {
-                    async postMessage(message) 
-                    {
+  const auto transport = R"(
                         if (typeof window.chrome === 'undefined' || !window.chrome.webview) return;
                         return window.chrome.webview.postMessage(message);
-                    }
-                };
-                )");
+                )";
+  injectScript(
+      js::createBridge(transport, incomingCapacity_, incomingPolicy_, outgoing_ != nullptr));
 
   // Optional: inject drag-and-drop handler
   if (options.getOption<bool>(WebviewOptions::kActivateNativeDragAndDrop)) {
@@ -167,7 +167,19 @@ void Impl::initialize(const WebviewOptions& options) {
   notifyReady();
 }
 
-Impl::~Impl() = default;
+Impl::~Impl() { stopResourceWorkers(); }
+
+void Impl::reparent(void* window) {
+  if (platform_->webviewController) {
+    // The bounds are relative to the parent, the webview fills its new window until resized.
+    const auto hwnd = static_cast<HWND>(window);
+    platform_->webviewController->put_ParentWindow(hwnd);
+    RECT bounds{};
+    GetClientRect(hwnd, &bounds);
+    platform_->webviewController->put_Bounds(bounds);
+    platform_->webviewController->put_IsVisible(TRUE);
+  }
+}
 
 void Impl::enableDevTools(bool state) {
   wil::com_ptr<ICoreWebView2Settings> settings;
@@ -247,9 +259,7 @@ void Impl::loadHTMLString(const std::string& html) {
   platform_->webview->NavigateToString(s2ws(html).c_str());
 }
 
-void Impl::loadResources(Resources&& resources) {
-  resources_ = std::move(resources);
-
+void Impl::interceptResources() {
   if (!platform_->webResourceRequestedToken) {
     platform_->webResourceRequestedToken = EventRegistrationToken();
 
@@ -274,36 +284,73 @@ void Impl::loadResources(Resources&& resources) {
                 return hr;
               }
 
-              std::string requestedUrl = ws2s(url.get());
-
-              // Check if the requested URL matches the resource you want to load
-              auto it = std::find_if(resources_.begin(), resources_.end(),
-                                     [&](const Resource& resource) {
-                                       return (origin_ + resource.scheme) == requestedUrl;
-                                     });
-
-              if (it != resources_.end()) {
-                auto webview2 = platform_->webview.try_query<ICoreWebView2_2>();
-                if (webview2) {
-                  wil::com_ptr<ICoreWebView2Environment> env;
-                  webview2->get_Environment(&env);
-
-                  // Create an IStream object from the content
-                  wil::com_ptr<IStream> contentStream
-                      = SHCreateMemStream(reinterpret_cast<const BYTE*>(it->content.data()),
-                                          static_cast<UINT>(it->content.size()));
-
-                  wil::com_ptr<ICoreWebView2WebResourceResponse> response;
-                  hr = env->CreateWebResourceResponse(contentStream.get(), 200, L"OK",
-                                                      s2ws("Content-Type:" + it->mime).c_str(),
-                                                      &response);
-                  if (FAILED(hr)) {
-                    return hr;
-                  }
-
-                  args->put_Response(response.get());
+              ResourceRequest resourceRequest{ws2s(url.get())};
+              // WebView2 takes the whole content stream at once, route bodies are collected.
+              resourceRequest.streaming = false;
+              wil::unique_cotaskmem_string method;
+              if (SUCCEEDED(request->get_Method(&method)) && method) {
+                resourceRequest.method = ws2s(method.get());
+              }
+              wil::com_ptr<IStream> content;
+              if (SUCCEEDED(request->get_Content(&content)) && content) {
+                char buffer[16 * 1024];
+                ULONG read = 0;
+                while (SUCCEEDED(content->Read(buffer, sizeof(buffer), &read)) && read > 0) {
+                  resourceRequest.body.append(buffer, read);
                 }
               }
+              wil::com_ptr<ICoreWebView2HttpRequestHeaders> requestHeaders;
+              if (SUCCEEDED(request->get_Headers(&requestHeaders))) {
+                wil::unique_cotaskmem_string range;
+                if (SUCCEEDED(requestHeaders->GetHeader(L"Range", &range)) && range) {
+                  resourceRequest.range = ws2s(range.get());
+                }
+                wil::unique_cotaskmem_string ifNoneMatch;
+                if (SUCCEEDED(requestHeaders->GetHeader(L"If-None-Match", &ifNoneMatch))
+                    && ifNoneMatch) {
+                  resourceRequest.ifNoneMatch = ws2s(ifNoneMatch.get());
+                }
+              }
+
+              wil::com_ptr<ICoreWebView2Environment> env;
+              if (auto webview2 = platform_->webview.try_query<ICoreWebView2_2>()) {
+                webview2->get_Environment(&env);
+              }
+
+              // Files served from disk complete later, the deferral holds the request until then.
+              wil::com_ptr<ICoreWebView2Deferral> deferral;
+              hr = args->GetDeferral(&deferral);
+              if (FAILED(hr)) {
+                return hr;
+              }
+              wil::com_ptr<ICoreWebView2WebResourceRequestedEventArgs> eventArgs = args;
+
+              handleResourceRequest(
+                  std::move(resourceRequest),
+                  [env, deferral, eventArgs](std::optional<ResourceResponse> resourceResponse) {
+                    if (resourceResponse && env) {
+                      // Create an IStream object from the content, only the requested range is
+                      // copied
+                      const ResourceContent& body = resourceResponse->body;
+                      wil::com_ptr<IStream> contentStream
+                          = SHCreateMemStream(reinterpret_cast<const BYTE*>(body.data()),
+                                              static_cast<UINT>(body.size()));
+
+                      std::string headers;
+                      for (const auto& [name, value] : resourceResponse->headers) {
+                        headers += name + ": " + value + "\r\n";
+                      }
+
+                      wil::com_ptr<ICoreWebView2WebResourceResponse> response;
+                      if (SUCCEEDED(env->CreateWebResourceResponse(
+                              contentStream.get(), resourceResponse->status,
+                              s2ws(resourceResponse->reason).c_str(), s2ws(headers).c_str(),
+                              &response))) {
+                        eventArgs->put_Response(response.get());
+                      }
+                    }
+                    deferral->Complete();
+                  });
 
               return S_OK;
             })
@@ -314,9 +361,7 @@ void Impl::loadResources(Resources&& resources) {
 
 void Impl::serveResource(const std::string& resourceUrl) { navigate(origin_ + resourceUrl); }
 
-void Impl::clearResources() {
-  resources_.clear();
-
+void Impl::stopInterceptingResources() {
   if (platform_->webResourceRequestedToken) {
     platform_->webview->remove_WebResourceRequested(platform_->webResourceRequestedToken.value());
     platform_->webview->RemoveWebResourceRequestedFilter((s2ws(origin_) + L"*").c_str(),
@@ -337,4 +382,46 @@ void Impl::injectScript(const std::string& script) {
 
 void Impl::executeScript(const std::string& script) {
   platform_->webview->ExecuteScript(s2ws(script).c_str(), nullptr);
+}
+
+void Impl::replaceCallbacksScript(const std::string& script) {
+  if (!platform_->callbacksScriptId.empty()) {
+    platform_->webview->RemoveScriptToExecuteOnDocumentCreated(
+        platform_->callbacksScriptId.c_str());
+    platform_->callbacksScriptId.clear();
+  }
+  const auto generation = ++platform_->callbacksScriptGeneration;
+  if (script.empty()) return;
+
+  // The script id is only known once the script is added. A script replaced in the meantime is
+  // removed as soon as its id arrives.
+  platform_->webview->AddScriptToExecuteOnDocumentCreated(
+      s2ws(script).c_str(),
+      Callback<ICoreWebView2AddScriptToExecuteOnDocumentCreatedCompletedHandler>(
+          [this, generation](HRESULT errorCode, LPCWSTR id) -> HRESULT {
+            if (FAILED(errorCode) || !id) return S_OK;
+            if (generation == platform_->callbacksScriptGeneration) {
+              platform_->callbacksScriptId = id;
+            } else {
+              platform_->webview->RemoveScriptToExecuteOnDocumentCreated(id);
+            }
+            return S_OK;
+          })
+          .Get());
+}
+
+void Impl::evaluateScript(const std::string& script, ScriptCallback callback) {
+  // WebView2 already returns the result as compact JSON.
+  platform_->webview->ExecuteScript(
+      s2ws(script).c_str(),
+      Callback<ICoreWebView2ExecuteScriptCompletedHandler>(
+          [callback = std::move(callback)](HRESULT errorCode, LPCWSTR resultAsJson) -> HRESULT {
+            if (FAILED(errorCode) || !resultAsJson) {
+              callback(false, "Script evaluation failed");
+            } else {
+              callback(true, ws2s(resultAsJson));
+            }
+            return S_OK;
+          })
+          .Get());
 }
\ No newline at end of file
@@ -19,6 +19,7 @@
 #include <cstdlib>
 #include <functional>
 #include <optional>
+#include <string>
 #include <utility>
 
 #include "interfaces/webview_impl.h"
@@ -43,6 +44,9 @@ namespace deskgui {
     std::optional<EventRegistrationToken> webResourceRequestedToken;
     std::optional<EventRegistrationToken> acceleratorKeysToken;
 
+    std::wstring callbacksScriptId;
+    std::size_t callbacksScriptGeneration = 0;
+
     bool ephemeralSession_ = false;
     bool asyncMode_ = false;
     Webview::Impl* webviewImpl_ = nullptr;
@@ -0,0 +1,146 @@
+/**
+ * deskgui - A powerful and flexible C++ library to create web-based desktop applications.
+ *
+ * Copyright (c) 2023 deskgui
+ * MIT License
+ */
+
+#include <deskgui/resource_archive.h>
+
+#include <cstring>
+#include <memory>
+#include <stdexcept>
+#include <string_view>
+
+#include "utils/mapped_file.h"
+
+#if defined(_WIN32)
+#  include "utils/strings.h"
+#elif defined(__APPLE__)
+#  include <mach-o/dyld.h>
+
+#  include <vector>
+#endif
+
+using namespace deskgui;
+
+namespace {
+  /*
+   * Archive layout, written by cmake/resource_compiler/resource_archive.py. Integers are little
+   * endian and offsets are relative to the start of the archive.
+   *
+   *   Header (32 bytes)  magic[8] "DSKGUIRA", u32 version, u32 count, u64 index, u64 strings
+   *   Index              count entries of 48 bytes sorted by path:
+   *                      u64 data, u64 size, u32 path, u32 pathSize, u32 mime, u32 mimeSize,
+   *                      u32 encoding, u32 encodingSize, u32 hash, u32 hashSize (string offsets
+   *                      relative to strings)
+   *   Strings            UTF-8 paths, mime types, encodings and content hashes
+   *   Blobs              resource bytes, each aligned to 16 bytes. Entries storing the same
+   *                      bytes share one blob.
+   *
+   * An archive appended to another file is followed by a 16 bytes footer: u64 archive size and
+   * the magic.
+   */
+  constexpr std::string_view kMagic = "DSKGUIRA";
+  constexpr std::uint32_t kVersion = 2;
+  constexpr std::size_t kHeaderSize = 32;
+  constexpr std::size_t kEntrySize = 48;
+  constexpr std::size_t kFooterSize = 16;
+
+  template <typename T> T read(const std::uint8_t* data) {
+    T value;
+    std::memcpy(&value, data, sizeof(T));
+    return value;
+  }
+
+  bool hasMagic(const std::uint8_t* data) {
+    return std::memcmp(data, kMagic.data(), kMagic.size()) == 0;
+  }
+
+  std::string_view archiveBytes(const utils::MappedFile& file, const std::string& path) {
+    const auto* data = file.data();
+    const auto size = file.size();
+    if (size >= kHeaderSize && hasMagic(data)) {
+      return {reinterpret_cast<const char*>(data), size};
+    }
+    if (size >= kFooterSize + kHeaderSize && hasMagic(data + size - kMagic.size())) {
+      const auto archiveSize = read<std::uint64_t>(data + size - kFooterSize);
+      if (archiveSize <= size - kFooterSize) {
+        const auto* start = data + size - kFooterSize - archiveSize;
+        return {reinterpret_cast<const char*>(start), static_cast<std::size_t>(archiveSize)};
+      }
+    }
+    throw std::runtime_error(path + " is not a resource archive");
+  }
+
+  std::string executablePath() {
+#if defined(_WIN32)
+    std::wstring path(MAX_PATH, L'\0');
+    DWORD length = 0;
+    while ((length = GetModuleFileNameW(nullptr, path.data(), static_cast<DWORD>(path.size())))
+           == path.size()) {
+      path.resize(path.size() * 2);
+    }
+    path.resize(length);
+    return utils::ws2s(path);
+#elif defined(__APPLE__)
+    std::uint32_t size = 0;
+    _NSGetExecutablePath(nullptr, &size);
+    std::vector<char> path(size);
+    if (_NSGetExecutablePath(path.data(), &size) != 0) {
+      throw std::runtime_error("Failed to locate the executable");
+    }
+    return path.data();
+#else
+    return "/proc/self/exe";
+#endif
+  }
+}  // namespace
+
+Resources deskgui::loadResourceArchive(const std::string& path) {
+  auto file = std::make_shared<const utils::MappedFile>(path);
+  const auto archive = archiveBytes(*file, path);
+  const auto* data = reinterpret_cast<const std::uint8_t*>(archive.data());
+  const auto size = archive.size();
+
+  const auto invalid = [&path]() {
+    return std::runtime_error(path + " is a corrupt resource archive");
+  };
+  const auto inBounds = [size](std::uint64_t offset, std::uint64_t length) {
+    return offset <= size && length <= size - offset;
+  };
+
+  if (read<std::uint32_t>(data + 8) != kVersion) {
+    throw std::runtime_error(path + " has an unsupported resource archive version");
+  }
+  const auto count = read<std::uint32_t>(data + 12);
+  const auto index = read<std::uint64_t>(data + 16);
+  const auto strings = read<std::uint64_t>(data + 24);
+  if (!inBounds(index, static_cast<std::uint64_t>(count) * kEntrySize) || strings > size) {
+    throw invalid();
+  }
+
+  const auto string = [&](const std::uint8_t* field) {
+    const auto offset = strings + read<std::uint32_t>(field);
+    const auto length = read<std::uint32_t>(field + 4);
+    if (!inBounds(offset, length)) throw invalid();
+    return std::string(reinterpret_cast<const char*>(data + offset), length);
+  };
+
+  Resources resources;
+  resources.reserve(count);
+  for (std::uint32_t i = 0; i < count; ++i) {
+    const auto* entry = data + index + i * kEntrySize;
+    const auto offset = read<std::uint64_t>(entry);
+    const auto length = read<std::uint64_t>(entry + 8);
+    if (!inBounds(offset, length)) throw invalid();
+
+    resources.push_back(
+        {string(entry + 16),
+         ResourceContent::fromShared(file, data + offset, static_cast<std::size_t>(length)),
+         string(entry + 24), string(entry + 32), string(entry + 40)});
+  }
+  return resources;
+}
+
+Resources deskgui::loadAppendedResourceArchive() { return loadResourceArchive(executablePath()); }
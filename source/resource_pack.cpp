@@ -0,0 +1,48 @@
+/**
+ * deskgui - A powerful and flexible C++ library to create web-based desktop applications.
+ *
+ * Copyright (c) 2023 deskgui
+ * MIT License
+ */
+
+#include <deskgui/resource_pack.h>
+
+#include "utils/resource_index.h"
+
+using namespace deskgui;
+
+namespace {
+
+  std::vector<std::string> preloadPaths(const ResourceRegistry& registry) {
+    const auto paths = registry.preload();
+    return {paths.begin(), paths.end()};
+  }
+
+}  // namespace
+
+ResourcePack::ResourcePack(Resources resources, std::vector<std::string> preload)
+    : resources_(std::move(resources)),
+      index_(std::make_unique<utils::ResourceIndex>()),
+      preload_(std::move(preload)) {
+  index_->rebuild(resources_);
+}
+
+ResourcePack::ResourcePack(const ResourceRegistry& registry)
+    : index_(std::make_unique<utils::ResourceIndex>()),
+      registry_(registry),
+      preload_(preloadPaths(registry)) {}
+
+ResourcePack::~ResourcePack() = default;
+
+const Resource* ResourcePack::find(std::string_view path) const {
+  if (const auto* resource = index_->find(path)) return resource;
+
+  const auto* entry = registry_.find(path);
+  if (!entry) return nullptr;
+
+  // Entries become resources on their first request, untouched ones never allocate.
+  std::lock_guard<std::mutex> lock(resolvedMutex_);
+  auto& resource = resolved_[entry->path];
+  if (!resource) resource = std::make_unique<const Resource>(entry->toResource());
+  return resource.get();
+}
@@ -0,0 +1,147 @@
+/**
+ * deskgui - A powerful and flexible C++ library to create web-based desktop applications.
+ *
+ * Copyright (c) 2023 deskgui
+ * MIT License
+ */
+
+#include <deskgui/route.h>
+
+#include <algorithm>
+#include <cctype>
+
+#include "interfaces/webview_impl.h"
+
+using namespace deskgui;
+
+namespace {
+  // Bytes a handler may write ahead of the page before write blocks.
+  constexpr std::size_t kStreamCapacity = 1024 * 1024;
+
+  std::string reasonPhrase(int status) {
+    switch (status) {
+      case 200: return "OK";
+      case 201: return "Created";
+      case 202: return "Accepted";
+      case 204: return "No Content";
+      case 301: return "Moved Permanently";
+      case 302: return "Found";
+      case 303: return "See Other";
+      case 304: return "Not Modified";
+      case 307: return "Temporary Redirect";
+      case 308: return "Permanent Redirect";
+      case 400: return "Bad Request";
+      case 401: return "Unauthorized";
+      case 403: return "Forbidden";
+      case 404: return "Not Found";
+      case 405: return "Method Not Allowed";
+      case 409: return "Conflict";
+      case 413: return "Content Too Large";
+      case 415: return "Unsupported Media Type";
+      case 422: return "Unprocessable Content";
+      case 429: return "Too Many Requests";
+      case 500: return "Internal Server Error";
+      case 501: return "Not Implemented";
+      case 503: return "Service Unavailable";
+      default: return "";
+    }
+  }
+
+  bool equalsIgnoreCase(std::string_view a, std::string_view b) {
+    if (a.size() != b.size()) return false;
+    for (std::size_t i = 0; i < a.size(); ++i) {
+      if (std::tolower(static_cast<unsigned char>(a[i]))
+          != std::tolower(static_cast<unsigned char>(b[i]))) {
+        return false;
+      }
+    }
+    return true;
+  }
+}  // namespace
+
+RouteResponse::State::State(Webview::Impl::ResourceResponder respond, AppHandler* appHandler,
+                            std::shared_ptr<utils::ChunkedBodies> streams)
+    : respond(std::move(respond)), appHandler(appHandler), streams(std::move(streams)) {
+  response.mime = "application/octet-stream";
+}
+
+RouteResponse::State::~State() { send({}, true); }
+
+bool RouteResponse::State::send(std::string_view chunk, bool last) {
+  std::shared_ptr<utils::ChunkedBody> stream;
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (ended) return false;
+    ended = last;
+
+    if (!streams) {
+      buffered.append(chunk);
+      if (last) {
+        response.body = ResourceContent(buffered.begin(), buffered.end());
+        response.headers.emplace_back("Content-Length", std::to_string(buffered.size()));
+        buffered.clear();
+        complete();
+      }
+      return true;
+    }
+
+    // The status and headers are sent with the first chunk, the body follows as it is written.
+    if (!committed) {
+      response.stream = streams->create(kStreamCapacity);
+      complete();
+    }
+    stream = response.stream;
+  }
+
+  const bool written = stream->write(chunk);
+  if (last) stream->close();
+  return written;
+}
+
+void RouteResponse::State::fail() {
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (ended) return;
+    if (!committed) {
+      response.status = 500;
+      response.reason = reasonPhrase(500);
+      response.headers.clear();
+      response.mime = "text/plain";
+      buffered.clear();
+    }
+  }
+  send({}, true);
+}
+
+void RouteResponse::State::complete() {
+  committed = true;
+  const bool typed = std::any_of(response.headers.begin(), response.headers.end(),
+                                 [](const auto& header) {
+                                   return equalsIgnoreCase(header.first, "Content-Type");
+                                 });
+  if (!typed) response.headers.emplace_back("Content-Type", response.mime);
+  appHandler->postOnMainThread(
+      [respond = std::move(respond), response = response]() mutable {
+        respond(std::move(response));
+      });
+}
+
+RouteResponse::RouteResponse(std::shared_ptr<State> state) : state_(std::move(state)) {}
+
+void RouteResponse::setStatus(int status, const std::string& reason) {
+  std::lock_guard<std::mutex> lock(state_->mutex);
+  if (state_->committed) return;
+  state_->response.status = status;
+  state_->response.reason = reason.empty() ? reasonPhrase(status) : reason;
+}
+
+void RouteResponse::setHeader(const std::string& name, const std::string& value) {
+  std::lock_guard<std::mutex> lock(state_->mutex);
+  if (state_->committed) return;
+  if (equalsIgnoreCase(name, "Content-Type")) state_->response.mime = value;
+  state_->response.headers.emplace_back(name, value);
+}
+
+bool RouteResponse::write(std::string_view chunk) { return state_->send(chunk, false); }
+
+void RouteResponse::end(std::string_view chunk) { state_->send(chunk, true); }
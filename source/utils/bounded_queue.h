@@ -0,0 +1,114 @@
+/**
+ * deskgui - A powerful and flexible C++ library to create web-based desktop applications.
+ *
+ * Copyright (c) 2023 deskgui
+ * MIT License
+ */
+
+#pragma once
+
+#include <deskgui/types.h>
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace deskgui::utils {
+
+  /**
+   * BoundedQueue - A queue of keyed items drained in batches by a single consumer.
+   *
+   * push() reports when the consumer is idle and must be woken up; the consumer then calls
+   * drain() until it returns nothing, which marks it idle again. Once the capacity is reached the
+   * policy decides what happens to new items. A capacity of 0 means unbounded.
+   */
+  template <typename T> class BoundedQueue {
+  public:
+    BoundedQueue(std::size_t capacity, QueuePolicy policy)
+        : capacity_(capacity), policy_(policy) {}
+
+    /**
+     * Adds an item, returns true when the consumer has to be woken up. Blocking only happens
+     * when allowed by the caller, otherwise a full queue with the kBlock policy grows past its
+     * capacity.
+     */
+    bool push(T item, const std::string& key, bool mayBlock) {
+      std::unique_lock<std::mutex> lock(mutex_);
+
+      if (policy_ == QueuePolicy::kCoalesce && !key.empty()) {
+        auto existing = std::find_if(items_.begin(), items_.end(),
+                                     [&key](const Item& entry) { return entry.key == key; });
+        if (existing != items_.end()) {
+          existing->value = std::move(item);
+          ++dropped_;
+          return false;
+        }
+      }
+
+      if (full()) {
+        if (policy_ == QueuePolicy::kBlock) {
+          if (mayBlock) {
+            spaceAvailable_.wait(lock, [this] { return !full(); });
+          }
+        } else {
+          items_.pop_front();
+          ++dropped_;
+        }
+      }
+
+      items_.push_back({key, std::move(item)});
+      if (busy_) return false;
+      busy_ = true;
+      return true;
+    }
+
+    /**
+     * Takes every queued item. An empty result means the consumer is idle until the next push().
+     */
+    std::vector<T> drain() {
+      std::vector<T> batch;
+      {
+        std::lock_guard<std::mutex> lock(mutex_);
+        batch.reserve(items_.size());
+        for (auto& entry : items_) {
+          batch.push_back(std::move(entry.value));
+        }
+        items_.clear();
+        busy_ = !batch.empty();
+      }
+      spaceAvailable_.notify_all();
+      return batch;
+    }
+
+    [[nodiscard]] std::size_t size() const {
+      std::lock_guard<std::mutex> lock(mutex_);
+      return items_.size();
+    }
+
+    [[nodiscard]] std::size_t dropped() const {
+      std::lock_guard<std::mutex> lock(mutex_);
+      return dropped_;
+    }
+
+  private:
+    struct Item {
+      std::string key;
+      T value;
+    };
+
+    bool full() const { return capacity_ > 0 && items_.size() >= capacity_; }
+
+    const std::size_t capacity_;
+    const QueuePolicy policy_;
+    mutable std::mutex mutex_;
+    std::condition_variable spaceAvailable_;
+    std::deque<Item> items_;
+    std::size_t dropped_{0};
+    bool busy_{false};
+  };
+
+}  // namespace deskgui::utils
@@ -0,0 +1,141 @@
+/**
+ * deskgui - A powerful and flexible C++ library to create web-based desktop applications.
+ *
+ * Copyright (c) 2023 deskgui
+ * MIT License
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace deskgui::utils {
+
+  /**
+   * ChunkedBody - Response body written by one thread while another one reads it.
+   *
+   * Writers block while more than the capacity waits to be read. Readers block until bytes are
+   * written or the body is closed. A reader that goes away cancels the body, which wakes and
+   * fails the writer.
+   */
+  class ChunkedBody {
+  public:
+    explicit ChunkedBody(std::size_t capacity) : capacity_(capacity) {}
+
+    ChunkedBody(const ChunkedBody&) = delete;
+    ChunkedBody& operator=(const ChunkedBody&) = delete;
+
+    // Returns false once the body is cancelled or closed.
+    bool write(std::string_view chunk) {
+      std::unique_lock<std::mutex> lock(mutex_);
+      canWrite_.wait(lock, [this] { return cancelled_ || buffered_ < capacity_; });
+      if (cancelled_ || closed_) return false;
+      if (chunk.empty()) return true;
+      chunks_.emplace_back(chunk);
+      buffered_ += chunk.size();
+      canRead_.notify_one();
+      return true;
+    }
+
+    void close() {
+      std::lock_guard<std::mutex> lock(mutex_);
+      closed_ = true;
+      canRead_.notify_all();
+    }
+
+    // Returns the number of bytes copied, 0 once the body is closed and read, or cancelled.
+    std::size_t read(std::uint8_t* buffer, std::size_t size) {
+      std::unique_lock<std::mutex> lock(mutex_);
+      canRead_.wait(lock, [this] { return cancelled_ || closed_ || !chunks_.empty(); });
+      std::size_t copied = 0;
+      while (!cancelled_ && !chunks_.empty() && copied < size) {
+        const auto& chunk = chunks_.front();
+        const auto count = std::min(size - copied, chunk.size() - offset_);
+        std::memcpy(buffer + copied, chunk.data() + offset_, count);
+        copied += count;
+        offset_ += count;
+        if (offset_ == chunk.size()) {
+          chunks_.pop_front();
+          offset_ = 0;
+        }
+      }
+      buffered_ -= copied;
+      canWrite_.notify_all();
+      return copied;
+    }
+
+    void cancel() {
+      std::lock_guard<std::mutex> lock(mutex_);
+      cancelled_ = true;
+      chunks_.clear();
+      buffered_ = 0;
+      canRead_.notify_all();
+      canWrite_.notify_all();
+    }
+
+    [[nodiscard]] bool cancelled() {
+      std::lock_guard<std::mutex> lock(mutex_);
+      return cancelled_;
+    }
+
+  private:
+    const std::size_t capacity_;
+    std::mutex mutex_;
+    std::condition_variable canRead_;
+    std::condition_variable canWrite_;
+    std::deque<std::string> chunks_;
+    std::size_t offset_{0};  // Bytes of the front chunk already read.
+    std::size_t buffered_{0};
+    bool closed_{false};
+    bool cancelled_{false};
+  };
+
+  /**
+   * ChunkedBodies - Creates the bodies of a reader and cancels those still alive at once, when
+   * the reader goes away. Bodies created after that are cancelled from the start.
+   */
+  class ChunkedBodies {
+  public:
+    std::shared_ptr<ChunkedBody> create(std::size_t capacity) {
+      auto body = std::make_shared<ChunkedBody>(capacity);
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (cancelled_) {
+        body->cancel();
+        return body;
+      }
+      bodies_.erase(std::remove_if(bodies_.begin(), bodies_.end(),
+                                   [](const auto& weak) { return weak.expired(); }),
+                    bodies_.end());
+      bodies_.push_back(body);
+      return body;
+    }
+
+    void cancel() {
+      std::vector<std::weak_ptr<ChunkedBody>> bodies;
+      {
+        std::lock_guard<std::mutex> lock(mutex_);
+        cancelled_ = true;
+        bodies.swap(bodies_);
+      }
+      for (const auto& weak : bodies) {
+        if (auto body = weak.lock()) body->cancel();
+      }
+    }
+
+  private:
+    std::mutex mutex_;
+    std::vector<std::weak_ptr<ChunkedBody>> bodies_;
+    bool cancelled_{false};
+  };
+
+}  // namespace deskgui::utils
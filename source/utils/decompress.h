@@ -0,0 +1,126 @@
+/**
+ * deskgui - A powerful and flexible C++ library to create web-based desktop applications.
+ *
+ * Copyright (c) 2023 deskgui
+ * MIT License
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string_view>
+#include <vector>
+
+#ifdef DESKGUI_HAS_ZLIB
+#  include <zlib.h>
+#endif
+
+#ifdef DESKGUI_HAS_BROTLI
+#  include <brotli/decode.h>
+#endif
+
+#ifdef DESKGUI_HAS_ZSTD
+#  include <zstd.h>
+#endif
+
+namespace deskgui::utils {
+
+  using Bytes = std::vector<std::uint8_t>;
+
+  namespace detail {
+    constexpr std::size_t kDecompressChunk = 64 * 1024;
+
+#ifdef DESKGUI_HAS_ZLIB
+    inline std::optional<Bytes> gunzip(const std::uint8_t* data, std::size_t size) {
+      z_stream stream{};
+      if (inflateInit2(&stream, 16 + MAX_WBITS) != Z_OK) return std::nullopt;
+
+      Bytes output;
+      stream.next_in = const_cast<Bytef*>(data);
+      stream.avail_in = static_cast<uInt>(size);
+      int result = Z_OK;
+      while (result == Z_OK) {
+        const auto written = output.size();
+        output.resize(written + kDecompressChunk);
+        stream.next_out = output.data() + written;
+        stream.avail_out = static_cast<uInt>(kDecompressChunk);
+        result = inflate(&stream, Z_NO_FLUSH);
+        output.resize(written + kDecompressChunk - stream.avail_out);
+      }
+      inflateEnd(&stream);
+      if (result != Z_STREAM_END) return std::nullopt;
+      return output;
+    }
+#endif
+
+#ifdef DESKGUI_HAS_BROTLI
+    inline std::optional<Bytes> unbrotli(const std::uint8_t* data, std::size_t size) {
+      BrotliDecoderState* state = BrotliDecoderCreateInstance(nullptr, nullptr, nullptr);
+      if (!state) return std::nullopt;
+
+      Bytes output;
+      const std::uint8_t* next = data;
+      std::size_t available = size;
+      BrotliDecoderResult result = BROTLI_DECODER_RESULT_NEEDS_MORE_OUTPUT;
+      while (result == BROTLI_DECODER_RESULT_NEEDS_MORE_OUTPUT) {
+        const auto written = output.size();
+        output.resize(written + kDecompressChunk);
+        std::uint8_t* out = output.data() + written;
+        std::size_t space = kDecompressChunk;
+        result = BrotliDecoderDecompressStream(state, &available, &next, &space, &out, nullptr);
+        output.resize(written + kDecompressChunk - space);
+      }
+      BrotliDecoderDestroyInstance(state);
+      if (result != BROTLI_DECODER_RESULT_SUCCESS) return std::nullopt;
+      return output;
+    }
+#endif
+
+#ifdef DESKGUI_HAS_ZSTD
+    inline std::optional<Bytes> unzstd(const std::uint8_t* data, std::size_t size) {
+      ZSTD_DStream* stream = ZSTD_createDStream();
+      if (!stream) return std::nullopt;
+
+      Bytes output;
+      ZSTD_inBuffer input{data, size, 0};
+      std::size_t result = 1;
+      while (result != 0) {
+        const auto written = output.size();
+        output.resize(written + kDecompressChunk);
+        ZSTD_outBuffer out{output.data() + written, kDecompressChunk, 0};
+        result = ZSTD_decompressStream(stream, &out, &input);
+        output.resize(written + out.pos);
+        if (ZSTD_isError(result) || (input.pos == input.size && out.pos == 0 && result != 0)) {
+          ZSTD_freeDStream(stream);
+          return std::nullopt;
+        }
+      }
+      ZSTD_freeDStream(stream);
+      return output;
+    }
+#endif
+  }  // namespace detail
+
+  /**
+   * Decodes bytes stored with a Content-Encoding ("gzip", "br" or "zstd").
+   *
+   * Returns nothing when the data is corrupt or the decoder was not available at build time.
+   */
+  inline std::optional<Bytes> decompress([[maybe_unused]] std::string_view encoding,
+                                         [[maybe_unused]] const std::uint8_t* data,
+                                         [[maybe_unused]] std::size_t size) {
+#ifdef DESKGUI_HAS_ZLIB
+    if (encoding == "gzip") return detail::gunzip(data, size);
+#endif
+#ifdef DESKGUI_HAS_BROTLI
+    if (encoding == "br") return detail::unbrotli(data, size);
+#endif
+#ifdef DESKGUI_HAS_ZSTD
+    if (encoding == "zstd") return detail::unzstd(data, size);
+#endif
+    return std::nullopt;
+  }
+
+}  // namespace deskgui::utils
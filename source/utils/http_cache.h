@@ -0,0 +1,72 @@
+/**
+ * deskgui - A powerful and flexible C++ library to create web-based desktop applications.
+ *
+ * Copyright (c) 2023 deskgui
+ * MIT License
+ */
+
+#pragma once
+
+#include <cctype>
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+namespace deskgui::utils {
+
+  // Strong entity tag of a content hash.
+  inline std::string entityTag(std::string_view hash) {
+    return "\"" + std::string(hash) + "\"";
+  }
+
+  /**
+   * Whether an If-None-Match header value matches an entity tag (RFC 9110 weak comparison).
+   */
+  inline bool matchesEntityTag(std::string_view ifNoneMatch, std::string_view tag) {
+    while (!ifNoneMatch.empty()) {
+      const auto comma = ifNoneMatch.find(',');
+      auto candidate = ifNoneMatch.substr(0, comma);
+      ifNoneMatch = comma == std::string_view::npos ? std::string_view{}
+                                                    : ifNoneMatch.substr(comma + 1);
+
+      while (!candidate.empty() && std::isspace(static_cast<unsigned char>(candidate.front()))) {
+        candidate.remove_prefix(1);
+      }
+      while (!candidate.empty() && std::isspace(static_cast<unsigned char>(candidate.back()))) {
+        candidate.remove_suffix(1);
+      }
+      if (candidate == "*") return true;
+      if (candidate.substr(0, 2) == "W/") candidate.remove_prefix(2);
+      if (candidate == tag) return true;
+    }
+    return false;
+  }
+
+  /**
+   * Whether a path names a file whose name carries a hash of its content, as emitted by bundlers
+   * ("app.3f2a9c1b.js", "index-D8KjL2hW.css"). Such a path always serves the same bytes.
+   */
+  inline bool isContentHashedPath(std::string_view path) {
+    const auto slash = path.rfind('/');
+    auto name = slash == std::string_view::npos ? path : path.substr(slash + 1);
+    const auto extension = name.rfind('.');
+    if (extension == std::string_view::npos || extension == 0) return false;
+    name = name.substr(0, extension);
+
+    const auto separator = name.find_last_of(".-");
+    if (separator == std::string_view::npos) return false;
+    const auto hash = name.substr(separator + 1);
+    if (hash.size() < 8 || hash.size() > 64) return false;
+
+    bool digit = false;
+    for (char c : hash) {
+      if (std::isdigit(static_cast<unsigned char>(c))) {
+        digit = true;
+      } else if (!std::isalpha(static_cast<unsigned char>(c)) && c != '_') {
+        return false;
+      }
+    }
+    return digit;
+  }
+
+}  // namespace deskgui::utils
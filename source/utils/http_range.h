@@ -0,0 +1,101 @@
+/**
+ * deskgui - A powerful and flexible C++ library to create web-based desktop applications.
+ *
+ * Copyright (c) 2023 deskgui
+ * MIT License
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <limits>
+#include <optional>
+#include <string>
+#include <string_view>
+
+namespace deskgui::utils {
+
+  struct ByteRange {
+    std::size_t offset{0};
+    std::size_t length{0};
+  };
+
+  enum class RangeStatus {
+    kNone,           // No range, or one that must be ignored: serve the whole content.
+    kSatisfiable,    // Serve the range with 206 Partial Content.
+    kUnsatisfiable,  // Answer 416 Range Not Satisfiable.
+  };
+
+  namespace detail {
+    inline std::string_view trim(std::string_view text) {
+      while (!text.empty() && (text.front() == ' ' || text.front() == '\t')) text.remove_prefix(1);
+      while (!text.empty() && (text.back() == ' ' || text.back() == '\t')) text.remove_suffix(1);
+      return text;
+    }
+
+    inline std::optional<std::size_t> parseSize(std::string_view text) {
+      if (text.empty()) return std::nullopt;
+      std::size_t value = 0;
+      for (char c : text) {
+        if (c < '0' || c > '9') return std::nullopt;
+        const auto digit = static_cast<std::size_t>(c - '0');
+        if (value > (std::numeric_limits<std::size_t>::max() - digit) / 10) return std::nullopt;
+        value = value * 10 + digit;
+      }
+      return value;
+    }
+  }  // namespace detail
+
+  /**
+   * Parses the value of a Range request header (RFC 9110) for content of the given size.
+   *
+   * Only single byte ranges are served, multiple ranges and invalid values are ignored as the
+   * RFC allows, so the whole content is served instead.
+   */
+  inline RangeStatus parseRange(std::string_view header, std::size_t size, ByteRange& range) {
+    header = detail::trim(header);
+    constexpr std::string_view kUnit = "bytes=";
+    if (header.substr(0, kUnit.size()) != kUnit) return RangeStatus::kNone;
+    header.remove_prefix(kUnit.size());
+    if (header.find(',') != std::string_view::npos) return RangeStatus::kNone;
+
+    const auto dash = header.find('-');
+    if (dash == std::string_view::npos) return RangeStatus::kNone;
+    const auto first = detail::trim(header.substr(0, dash));
+    const auto last = detail::trim(header.substr(dash + 1));
+
+    // Suffix range: the last N bytes.
+    if (first.empty()) {
+      const auto suffix = detail::parseSize(last);
+      if (!suffix) return RangeStatus::kNone;
+      if (*suffix == 0 || size == 0) return RangeStatus::kUnsatisfiable;
+      range.length = *suffix < size ? *suffix : size;
+      range.offset = size - range.length;
+      return RangeStatus::kSatisfiable;
+    }
+
+    const auto offset = detail::parseSize(first);
+    if (!offset) return RangeStatus::kNone;
+    std::size_t end = size;  // Exclusive
+    if (!last.empty()) {
+      const auto lastByte = detail::parseSize(last);
+      if (!lastByte || *lastByte < *offset) return RangeStatus::kNone;
+      if (*lastByte < size) end = *lastByte + 1;
+    }
+    if (*offset >= size) return RangeStatus::kUnsatisfiable;
+
+    range.offset = *offset;
+    range.length = end - *offset;
+    return RangeStatus::kSatisfiable;
+  }
+
+  // Value of the Content-Range header of a 206 response.
+  inline std::string contentRange(const ByteRange& range, std::size_t size) {
+    return "bytes " + std::to_string(range.offset) + "-"
+           + std::to_string(range.offset + range.length - 1) + "/" + std::to_string(size);
+  }
+
+  // Value of the Content-Range header of a 416 response.
+  inline std::string unsatisfiedRange(std::size_t size) { return "bytes */" + std::to_string(size); }
+
+}  // namespace deskgui::utils
@@ -0,0 +1,77 @@
+/**
+ * deskgui - A powerful and flexible C++ library to create web-based desktop applications.
+ *
+ * Copyright (c) 2023 deskgui
+ * MIT License
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <list>
+#include <optional>
+#include <unordered_map>
+#include <utility>
+
+namespace deskgui::utils {
+
+  /**
+   * LruCache - Least recently used cache bounded by the total cost of its entries.
+   *
+   * Entries costing more than the whole capacity are never stored. Not thread safe.
+   */
+  template <typename Key, typename Value> class LruCache {
+  public:
+    explicit LruCache(std::size_t capacity) : capacity_(capacity) {}
+
+    std::optional<Value> get(const Key& key) {
+      auto it = index_.find(key);
+      if (it == index_.end()) return std::nullopt;
+      entries_.splice(entries_.begin(), entries_, it->second);
+      return it->second->value;
+    }
+
+    void put(const Key& key, Value value, std::size_t cost) {
+      erase(key);
+      if (cost > capacity_) return;
+
+      while (size_ + cost > capacity_) {
+        size_ -= entries_.back().cost;
+        index_.erase(entries_.back().key);
+        entries_.pop_back();
+      }
+      entries_.push_front({key, std::move(value), cost});
+      index_[key] = entries_.begin();
+      size_ += cost;
+    }
+
+    void erase(const Key& key) {
+      auto it = index_.find(key);
+      if (it == index_.end()) return;
+      size_ -= it->second->cost;
+      entries_.erase(it->second);
+      index_.erase(it);
+    }
+
+    void clear() {
+      entries_.clear();
+      index_.clear();
+      size_ = 0;
+    }
+
+    [[nodiscard]] std::size_t size() const { return size_; }
+
+  private:
+    struct Entry {
+      Key key;
+      Value value;
+      std::size_t cost;
+    };
+
+    std::size_t capacity_;
+    std::size_t size_{0};
+    std::list<Entry> entries_;
+    std::unordered_map<Key, typename std::list<Entry>::iterator> index_;
+  };
+
+}  // namespace deskgui::utils
@@ -0,0 +1,100 @@
+/**
+ * deskgui - A powerful and flexible C++ library to create web-based desktop applications.
+ *
+ * Copyright (c) 2023 deskgui
+ * MIT License
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+
+#ifdef _WIN32
+#  include "utils/strings.h"
+#else
+#  include <fcntl.h>
+#  include <sys/mman.h>
+#  include <sys/stat.h>
+#  include <unistd.h>
+#endif
+
+namespace deskgui::utils {
+
+  /**
+   * MappedFile - Read-only memory mapping of a whole file.
+   *
+   * Pages are loaded by the system on first access and shared with every other process mapping
+   * the same file.
+   */
+  class MappedFile {
+  public:
+    explicit MappedFile(const std::string& path) {
+#ifdef _WIN32
+      file_ = CreateFileW(s2ws(path).c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                          OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+      if (file_ == INVALID_HANDLE_VALUE) {
+        throw std::runtime_error("Failed to open " + path);
+      }
+      LARGE_INTEGER size{};
+      if (!GetFileSizeEx(file_, &size) || size.QuadPart == 0) {
+        CloseHandle(file_);
+        throw std::runtime_error("Failed to map empty file " + path);
+      }
+      mapping_ = CreateFileMappingW(file_, nullptr, PAGE_READONLY, 0, 0, nullptr);
+      void* view = mapping_ ? MapViewOfFile(mapping_, FILE_MAP_READ, 0, 0, 0) : nullptr;
+      if (!view) {
+        if (mapping_) CloseHandle(mapping_);
+        CloseHandle(file_);
+        throw std::runtime_error("Failed to map " + path);
+      }
+      data_ = static_cast<const std::uint8_t*>(view);
+      size_ = static_cast<std::size_t>(size.QuadPart);
+#else
+      const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+      if (fd < 0) {
+        throw std::runtime_error("Failed to open " + path);
+      }
+      struct stat status {};
+      if (::fstat(fd, &status) != 0 || status.st_size == 0) {
+        ::close(fd);
+        throw std::runtime_error("Failed to map empty file " + path);
+      }
+      size_ = static_cast<std::size_t>(status.st_size);
+      void* view = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+      ::close(fd);  // The mapping keeps its own reference to the file.
+      if (view == MAP_FAILED) {
+        throw std::runtime_error("Failed to map " + path);
+      }
+      data_ = static_cast<const std::uint8_t*>(view);
+#endif
+    }
+
+    ~MappedFile() {
+#ifdef _WIN32
+      UnmapViewOfFile(data_);
+      CloseHandle(mapping_);
+      CloseHandle(file_);
+#else
+      ::munmap(const_cast<std::uint8_t*>(data_), size_);
+#endif
+    }
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    [[nodiscard]] const std::uint8_t* data() const { return data_; }
+    [[nodiscard]] std::size_t size() const { return size_; }
+
+  private:
+#ifdef _WIN32
+    HANDLE file_{INVALID_HANDLE_VALUE};
+    HANDLE mapping_{nullptr};
+#endif
+    const std::uint8_t* data_{nullptr};
+    std::size_t size_{0};
+  };
+
+}  // namespace deskgui::utils
@@ -0,0 +1,106 @@
+/**
+ * deskgui - A powerful and flexible C++ library to create web-based desktop applications.
+ *
+ * Copyright (c) 2023 deskgui
+ * MIT License
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cctype>
+#include <string>
+#include <string_view>
+#include <utility>
+
+namespace deskgui::utils {
+
+  namespace detail {
+    // Extension to MIME type table of the resource compiler
+    // (cmake/resource_compiler/mime_types.py), sorted by extension for a binary search.
+    inline constexpr std::array<std::pair<std::string_view, std::string_view>, 65> kMimeTypes{{
+        {".3g2", "video/3gpp2"},
+        {".3gp", "video/3gpp"},
+        {".7z", "application/x-7z-compressed"},
+        {".aac", "audio/aac"},
+        {".abw", "application/x-abiword"},
+        {".arc", "application/octet-stream"},
+        {".avi", "video/x-msvideo"},
+        {".azw", "application/vnd.amazon.ebook"},
+        {".bin", "application/octet-stream"},
+        {".bz", "application/x-bzip"},
+        {".bz2", "application/x-bzip2"},
+        {".csh", "application/x-csh"},
+        {".css", "text/css"},
+        {".csv", "text/csv"},
+        {".doc", "application/msword"},
+        {".epub", "application/epub+zip"},
+        {".gif", "image/gif"},
+        {".html", "text/html"},
+        {".ico", "image/x-icon"},
+        {".ics", "text/calendar"},
+        {".jar", "application/java-archive"},
+        {".jpeg", "image/jpeg"},
+        {".jpg", "image/jpeg"},
+        {".js", "application/javascript"},
+        {".json", "application/json"},
+        {".mid", "audio/midi"},
+        {".midi", "audio/midi"},
+        {".mjs", "application/javascript"},
+        {".mp3", "audio/mpeg"},
+        {".mp4", "video/mp4"},
+        {".mpeg", "video/mpeg"},
+        {".mpkg", "application/vnd.apple.installer+xml"},
+        {".odp", "application/vnd.oasis.opendocument.presentation"},
+        {".ods", "application/vnd.oasis.opendocument.spreadsheet"},
+        {".odt", "application/vnd.oasis.opendocument.text"},
+        {".oga", "audio/ogg"},
+        {".ogg", "audio/ogg"},
+        {".ogv", "video/ogg"},
+        {".ogx", "application/ogg"},
+        {".pdf", "application/pdf"},
+        {".png", "image/png"},
+        {".ppt", "application/vnd.ms-powerpoint"},
+        {".rar", "application/x-rar-compressed"},
+        {".rtf", "application/rtf"},
+        {".sh", "application/x-sh"},
+        {".svg", "image/svg+xml"},
+        {".swf", "application/x-shockwave-flash"},
+        {".tar", "application/x-tar"},
+        {".tif", "image/tiff"},
+        {".tiff", "image/tiff"},
+        {".ttf", "font/ttf"},
+        {".txt", "text/plain"},
+        {".vsd", "application/vnd.visio"},
+        {".wasm", "application/wasm"},
+        {".wav", "audio/x-wav"},
+        {".weba", "audio/webm"},
+        {".webm", "video/webm"},
+        {".webp", "image/webp"},
+        {".woff", "font/woff"},
+        {".woff2", "font/woff2"},
+        {".xhtml", "application/xhtml+xml"},
+        {".xls", "application/vnd.ms-excel"},
+        {".xml", "application/xml"},
+        {".xul", "application/vnd.mozilla.xul+xml"},
+        {".zip", "application/zip"},
+    }};
+  }  // namespace detail
+
+  /**
+   * MIME type of a file extension (".html"), as assigned by the resource compiler
+   * (cmake/resource_compiler/mime_types.py). Unknown extensions are application/octet-stream.
+   */
+  inline std::string_view mimeType(std::string_view extension) {
+    std::string lower(extension);
+    std::transform(lower.begin(), lower.end(), lower.begin(),
+                   [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+    const auto it = std::lower_bound(
+        detail::kMimeTypes.begin(), detail::kMimeTypes.end(), std::string_view(lower),
+        [](const auto& entry, std::string_view key) { return entry.first < key; });
+    if (it != detail::kMimeTypes.end() && it->first == lower) return it->second;
+    return "application/octet-stream";
+  }
+
+}  // namespace deskgui::utils
@@ -0,0 +1,104 @@
+/**
+ * deskgui - A powerful and flexible C++ library to create web-based desktop applications.
+ *
+ * Copyright (c) 2023 deskgui
+ * MIT License
+ */
+
+#pragma once
+
+#include <cctype>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+namespace deskgui::utils {
+
+  // Whether a MIME type (with or without parameters) is the one of an HTML page.
+  inline bool isHtml(std::string_view mime) {
+    return mime.substr(0, mime.find(';')) == "text/html";
+  }
+
+  /**
+   * Link asking the webview to fetch a resource before the page references it. The "as"
+   * attribute follows the MIME type, fonts and fetched data are requested in CORS mode as the
+   * page will request them.
+   */
+  inline std::string preloadLink(std::string_view url, std::string_view mime) {
+    std::string_view destination = "fetch";
+    if (mime == "text/css") {
+      destination = "style";
+    } else if (mime.find("javascript") != std::string_view::npos) {
+      destination = "script";
+    } else if (mime.substr(0, 5) == "font/" || mime.find("font-") != std::string_view::npos) {
+      destination = "font";
+    } else if (mime.substr(0, 6) == "image/") {
+      destination = "image";
+    }
+
+    std::string link = "<link rel=\"preload\" href=\"";
+    for (const char c : url) {
+      switch (c) {
+        case '"':
+          link += "&quot;";
+          break;
+        case '&':
+          link += "&amp;";
+          break;
+        case '<':
+          link += "&lt;";
+          break;
+        default:
+          link += c;
+      }
+    }
+    link += "\" as=\"";
+    link += destination;
+    link += destination == "font" || destination == "fetch" ? "\" crossorigin>" : "\">";
+    return link;
+  }
+
+  /**
+   * Inserts markup right after the opening tag of the head of a page, or of the html element
+   * when the head tag is omitted, or at the start of the page.
+   */
+  inline std::string insertIntoHead(std::string_view html, std::string_view markup) {
+    const auto tagEnd = [html](std::string_view name) -> std::size_t {
+      for (auto open = html.find('<'); open != std::string_view::npos;
+           open = html.find('<', open + 1)) {
+        if (html.size() - open <= name.size() + 1) break;
+        bool matches = true;
+        for (std::size_t i = 0; i < name.size() && matches; ++i) {
+          matches = std::tolower(static_cast<unsigned char>(html[open + 1 + i])) == name[i];
+        }
+        const auto next = static_cast<unsigned char>(html[open + 1 + name.size()]);
+        if (!matches || !(next == '>' || next == '/' || std::isspace(next))) continue;
+        const auto close = html.find('>', open);
+        return close == std::string_view::npos ? close : close + 1;
+      }
+      return std::string_view::npos;
+    };
+
+    auto position = tagEnd("head");
+    if (position == std::string_view::npos) position = tagEnd("html");
+    if (position == std::string_view::npos) position = 0;
+
+    std::string page;
+    page.reserve(html.size() + markup.size());
+    page.append(html.substr(0, position));
+    page.append(markup);
+    page.append(html.substr(position));
+    return page;
+  }
+
+  // FNV-1a hash, stable across runs, to tell apart the entity tags of rewritten pages.
+  inline std::uint64_t stableHash(std::string_view text) {
+    std::uint64_t hash = 14695981039346656037ull;
+    for (const char c : text) {
+      hash ^= static_cast<unsigned char>(c);
+      hash *= 1099511628211ull;
+    }
+    return hash;
+  }
+
+}  // namespace deskgui::utils
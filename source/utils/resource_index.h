@@ -0,0 +1,93 @@
+/**
+ * deskgui - A powerful and flexible C++ library to create web-based desktop applications.
+ *
+ * Copyright (c) 2023 deskgui
+ * MIT License
+ */
+
+#pragma once
+
+#include <deskgui/resource_compiler.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <string_view>
+#include <vector>
+
+namespace deskgui::utils {
+
+  /**
+   * ResourceIndex - Open addressing hash index over a Resources vector, keyed by scheme.
+   *
+   * Lookups hash the path once and compare strings only on a hash match, without allocating.
+   * The index stores positions into the vector, so it must be rebuilt whenever the vector
+   * changes. When several resources share a scheme the first one wins.
+   */
+  class ResourceIndex {
+  public:
+    void rebuild(const Resources& resources) {
+      resources_ = &resources;
+
+      // Keep the load factor at or below 1/2 so probe sequences stay short.
+      std::size_t capacity = 16;
+      while (capacity < resources.size() * 2) capacity <<= 1;
+      slots_.assign(capacity, Slot{});
+
+      for (std::size_t i = 0; i < resources.size(); ++i) {
+        const auto hash = hashOf(resources[i].scheme);
+        std::size_t slot = hash & (capacity - 1);
+        bool duplicate = false;
+        while (slots_[slot].index != kEmpty) {
+          if (slots_[slot].hash == hash && resources[slots_[slot].index].scheme
+                                               == resources[i].scheme) {
+            duplicate = true;
+            break;
+          }
+          slot = (slot + 1) & (capacity - 1);
+        }
+        if (!duplicate) slots_[slot] = {hash, static_cast<std::uint32_t>(i)};
+      }
+    }
+
+    void clear() {
+      slots_.clear();
+      resources_ = nullptr;
+    }
+
+    [[nodiscard]] const Resource* find(std::string_view path) const {
+      if (!resources_ || slots_.empty()) return nullptr;
+
+      const auto hash = hashOf(path);
+      const std::size_t mask = slots_.size() - 1;
+      for (std::size_t slot = hash & mask; slots_[slot].index != kEmpty;
+           slot = (slot + 1) & mask) {
+        const auto& resource = (*resources_)[slots_[slot].index];
+        if (slots_[slot].hash == hash && resource.scheme == path) return &resource;
+      }
+      return nullptr;
+    }
+
+  private:
+    static constexpr std::uint32_t kEmpty = std::numeric_limits<std::uint32_t>::max();
+
+    struct Slot {
+      std::uint64_t hash{0};
+      std::uint32_t index{kEmpty};
+    };
+
+    // FNV-1a
+    static std::uint64_t hashOf(std::string_view key) {
+      std::uint64_t hash = 14695981039346656037ull;
+      for (unsigned char c : key) {
+        hash ^= c;
+        hash *= 1099511628211ull;
+      }
+      return hash;
+    }
+
+    std::vector<Slot> slots_;
+    const Resources* resources_{nullptr};
+  };
+
+}  // namespace deskgui::utils
@@ -0,0 +1,58 @@
+/**
+ * deskgui - A powerful and flexible C++ library to create web-based desktop applications.
+ *
+ * Copyright (c) 2023 deskgui
+ * MIT License
+ */
+
+#pragma once
+
+#include <map>
+#include <string>
+#include <string_view>
+
+#include "utils/url.h"
+
+namespace deskgui::utils {
+
+  /**
+   * Matches a request path with a route pattern such as "api/users/:id", both relative to the
+   * origin. A ":name" segment captures one path segment and a final "*" segment captures the rest
+   * of the path, both percent-decoded into params.
+   */
+  inline bool matchRoute(std::string_view pattern, std::string_view path,
+                         std::map<std::string, std::string>& params) {
+    const auto next = [](std::string_view& text) {
+      const auto slash = text.find('/');
+      const auto segment = text.substr(0, slash);
+      text = slash == std::string_view::npos ? std::string_view{} : text.substr(slash + 1);
+      return segment;
+    };
+    const auto decoded = [](std::string_view text) {
+      auto value = percentDecode(text);
+      return value ? *value : std::string(text);
+    };
+
+    std::map<std::string, std::string> captured;
+    while (!pattern.empty()) {
+      if (pattern == "*") {
+        captured["*"] = decoded(path);
+        params = std::move(captured);
+        return true;
+      }
+      if (path.empty()) return false;
+      const auto expected = next(pattern);
+      const auto segment = next(path);
+      if (!expected.empty() && expected.front() == ':') {
+        if (segment.empty()) return false;
+        captured[std::string(expected.substr(1))] = decoded(segment);
+      } else if (expected != segment) {
+        return false;
+      }
+    }
+    if (!path.empty()) return false;
+    params = std::move(captured);
+    return true;
+  }
+
+}  // namespace deskgui::utils
@@ -0,0 +1,60 @@
+/**
+ * deskgui - A powerful and flexible C++ library to create web-based desktop applications.
+ *
+ * Copyright (c) 2023 deskgui
+ * MIT License
+ */
+
+#pragma once
+
+#include <optional>
+#include <string>
+#include <string_view>
+
+namespace deskgui::utils {
+
+  /**
+   * Decodes the %XX escapes of a URL path. Malformed escapes and encoded NUL bytes are rejected.
+   */
+  inline std::optional<std::string> percentDecode(std::string_view text) {
+    const auto hex = [](char c) -> int {
+      if (c >= '0' && c <= '9') return c - '0';
+      if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+      if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+      return -1;
+    };
+
+    std::string decoded;
+    decoded.reserve(text.size());
+    for (std::size_t i = 0; i < text.size(); ++i) {
+      if (text[i] != '%') {
+        decoded += text[i];
+        continue;
+      }
+      if (i + 2 >= text.size()) return std::nullopt;
+      const int high = hex(text[i + 1]);
+      const int low = hex(text[i + 2]);
+      if (high < 0 || low < 0 || (high == 0 && low == 0)) return std::nullopt;
+      decoded += static_cast<char>(high * 16 + low);
+      i += 2;
+    }
+    return decoded;
+  }
+
+  /**
+   * Whether a decoded URL path stays inside the directory it is resolved against: it is relative,
+   * has no ".." segment, and has no separator or drive syntax another platform would interpret.
+   */
+  inline bool isContainedPath(std::string_view path) {
+    if (!path.empty() && path.front() == '/') return false;
+    if (path.find_first_of("\\:") != std::string_view::npos) return false;
+    while (!path.empty()) {
+      const auto slash = path.find('/');
+      if (path.substr(0, slash) == "..") return false;
+      if (slash == std::string_view::npos) break;
+      path.remove_prefix(slash + 1);
+    }
+    return true;
+  }
+
+}  // namespace deskgui::utils
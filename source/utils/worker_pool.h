@@ -0,0 +1,132 @@
+/**
+ * deskgui - A powerful and flexible C++ library to create web-based desktop applications.
+ *
+ * Copyright (c) 2023 deskgui
+ * MIT License
+ */
+
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace deskgui::utils {
+  using Task = std::function<void()>;
+
+  /**
+   * WorkerPool - A fixed set of background threads running posted tasks in FIFO order.
+   *
+   * The destructor waits for the running tasks to finish and discards the queued ones.
+   */
+  class WorkerPool {
+  public:
+    explicit WorkerPool(std::size_t threads) {
+      threads_.reserve(threads);
+      for (std::size_t i = 0; i < threads; ++i) {
+        threads_.emplace_back([this] { work(); });
+      }
+    }
+
+    ~WorkerPool() {
+      {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopped_ = true;
+      }
+      condition_.notify_all();
+      for (auto& thread : threads_) {
+        thread.join();
+      }
+    }
+
+    WorkerPool(const WorkerPool&) = delete;
+    WorkerPool& operator=(const WorkerPool&) = delete;
+
+    void post(Task task) {
+      {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (stopped_) return;
+        tasks_.push_back(std::move(task));
+      }
+      condition_.notify_one();
+    }
+
+  private:
+    void work() {
+      while (true) {
+        Task task;
+        {
+          std::unique_lock<std::mutex> lock(mutex_);
+          condition_.wait(lock, [this] { return stopped_ || !tasks_.empty(); });
+          if (stopped_) return;
+          task = std::move(tasks_.front());
+          tasks_.pop_front();
+        }
+        task();
+      }
+    }
+
+    std::mutex mutex_;
+    std::condition_variable condition_;
+    std::deque<Task> tasks_;
+    bool stopped_ = false;
+    std::vector<std::thread> threads_;
+  };
+
+  /**
+   * SerialQueue - Runs its tasks one at a time and in posting order on a WorkerPool.
+   *
+   * Different queues sharing a pool run concurrently, which gives per-key ordering without
+   * dedicating a thread to each key. The queue stays alive until its tasks have run, even when
+   * its owner drops it, unless the pool itself is destroyed first.
+   */
+  class SerialQueue : public std::enable_shared_from_this<SerialQueue> {
+  public:
+    explicit SerialQueue(WorkerPool& pool) : pool_(pool) {}
+
+    void post(Task task) {
+      {
+        std::lock_guard<std::mutex> lock(mutex_);
+        tasks_.push_back(std::move(task));
+        if (scheduled_) return;
+        scheduled_ = true;
+      }
+      schedule();
+    }
+
+  private:
+    // Tasks run in small batches so a busy queue does not starve the others.
+    static constexpr std::size_t kBatchSize = 16;
+
+    void schedule() {
+      pool_.post([self = shared_from_this()] { self->drain(); });
+    }
+
+    void drain() {
+      for (std::size_t i = 0; i < kBatchSize; ++i) {
+        Task task;
+        {
+          std::lock_guard<std::mutex> lock(mutex_);
+          if (tasks_.empty()) {
+            scheduled_ = false;
+            return;
+          }
+          task = std::move(tasks_.front());
+          tasks_.pop_front();
+        }
+        task();
+      }
+      schedule();
+    }
+
+    WorkerPool& pool_;
+    std::mutex mutex_;
+    std::deque<Task> tasks_;
+    bool scheduled_ = false;
+  };
+}  // namespace deskgui::utils
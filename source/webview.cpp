@@ -5,21 +5,137 @@
  * MIT License
  */
 
-#include <rapidjson/document.h>
-#include <rapidjson/stringbuffer.h>
-#include <rapidjson/writer.h>
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <sstream>
 
 #include "interfaces/webview_impl.h"
+#include "js/bridge.h"
+#include "utils/decompress.h"
 #include "utils/dispatch.h"
+#include "utils/http_cache.h"
+#include "utils/http_range.h"
+#include "utils/mime_types.h"
+#include "utils/preload.h"
+#include "utils/route_pattern.h"
+#include "utils/url.h"
 
 using namespace deskgui;
 
+namespace {
+  QueuePolicy queuePolicy(const WebviewOptions& options, const char* key) {
+    if (!options.hasOption(key)) return QueuePolicy::kDropOldest;
+    const auto policy = options.getOption<std::string>(key);
+    if (policy == "block") return QueuePolicy::kBlock;
+    if (policy == "drop-oldest") return QueuePolicy::kDropOldest;
+    if (policy == "coalesce") return QueuePolicy::kCoalesce;
+    throw std::invalid_argument("Unknown queue policy: " + policy);
+  }
+
+  using ResourceRequest = Webview::Impl::ResourceRequest;
+  using ResourceResponse = Webview::Impl::ResourceResponse;
+
+  // Files up to this size are read whole and cached, larger ones are streamed in chunks.
+  constexpr std::size_t kMaxCachedFileSize = 1024 * 1024;
+  constexpr std::size_t kFileChunkSize = 64 * 1024;
+  constexpr std::size_t kFileStreamCapacity = 4 * kFileChunkSize;
+
+  /*
+   * Adds the caching headers of a response, and turns it into a 304 when the page already holds
+   * the content with the given entity tag. Content without a tag is not revalidated.
+   */
+  bool respondNotModified(const ResourceRequest& request, std::string_view path, std::string tag,
+                          ResourceResponse& response) {
+    // Bundlers put a hash of the content in the file name, such paths never change content.
+    // Other content with a known tag is revalidated, which costs a 304 and no decoding or read.
+    if (utils::isContentHashedPath(path)) {
+      response.headers.emplace_back("Cache-Control", "public, max-age=31536000, immutable");
+    } else if (!tag.empty()) {
+      response.headers.emplace_back("Cache-Control", "no-cache");
+    }
+    if (tag.empty()) return false;
+
+    const bool notModified = utils::matchesEntityTag(request.ifNoneMatch, tag);
+    response.headers.emplace_back("ETag", std::move(tag));
+    if (notModified) {
+      response.status = 304;
+      response.reason = "Not Modified";
+    }
+    return notModified;
+  }
+
+  /*
+   * Sets the body of a response to the requested range of content of the given size. Read sets
+   * the body to the bytes at an offset and length, and returns false if they cannot be read.
+   */
+  template <typename Read> bool respondWithRange(const ResourceRequest& request, std::size_t size,
+                                                 const Read& read, ResourceResponse& response) {
+    response.headers.emplace_back("Accept-Ranges", "bytes");
+
+    // Media elements seek with range requests, only the requested slice is handed to the webview.
+    utils::ByteRange range;
+    std::size_t length = 0;
+    switch (utils::parseRange(request.range, size, range)) {
+      case utils::RangeStatus::kNone:
+        if (!read(0, size)) return false;
+        length = size;
+        break;
+      case utils::RangeStatus::kSatisfiable:
+        if (!read(range.offset, range.length)) return false;
+        length = range.length;
+        response.status = 206;
+        response.reason = "Partial Content";
+        response.headers.emplace_back("Content-Range", utils::contentRange(range, size));
+        break;
+      case utils::RangeStatus::kUnsatisfiable:
+        response.status = 416;
+        response.reason = "Range Not Satisfiable";
+        response.headers.emplace_back("Content-Range", utils::unsatisfiedRange(size));
+        break;
+    }
+    response.headers.emplace_back("Content-Length", std::to_string(length));
+    return true;
+  }
+
+  // Files are read rather than mapped, a file truncated by an editor must not crash the process.
+  std::optional<ResourceContent> readFile(const std::filesystem::path& file, std::size_t offset,
+                                          std::size_t length) {
+    std::ifstream stream(file, std::ios::binary);
+    if (!stream) return std::nullopt;
+    std::vector<std::uint8_t> bytes(length);
+    stream.seekg(static_cast<std::streamoff>(offset));
+    stream.read(reinterpret_cast<char*>(bytes.data()), static_cast<std::streamsize>(length));
+    if (static_cast<std::size_t>(stream.gcount()) != length) return std::nullopt;
+    return ResourceContent(std::move(bytes));
+  }
+
+  // Writes the next length bytes of a file to a streamed body, one chunk at a time as the page
+  // reads them. A file truncated meanwhile ends the body early.
+  void streamFile(std::istream& file, std::size_t length, utils::ChunkedBody& body) {
+    std::string chunk;
+    while (length > 0) {
+      chunk.resize(std::min(length, kFileChunkSize));
+      file.read(chunk.data(), static_cast<std::streamsize>(chunk.size()));
+      const auto count = static_cast<std::size_t>(file.gcount());
+      if (count == 0 || !body.write({chunk.data(), count})) break;
+      length -= count;
+    }
+    body.close();
+  }
+}  // namespace
+
 Webview::Webview(const std::string& name, AppHandler* appHandler, void* window,
                  const WebviewOptions& options)
     : impl_(std::make_shared<Impl>(name, appHandler, window, options)), events_(&impl_->events()) {}
 
 Webview::~Webview() = default;
 
+void Webview::adopt(const std::string& name, void* window) {
+  impl_->setName(name);
+  impl_->reparent(window);
+}
+
 std::string Webview::getName() const { return utils::dispatch<&Impl::getName>(impl_); }
 
 bool Webview::isReady() const { return utils::dispatch<&Impl::isReady>(impl_); }
@@ -63,11 +179,32 @@ void Webview::Impl::notifyReady() {
   }
 }
 
-void Webview::Impl::addCallback(const std::string& key, MessageCallback callback) {
-  callbacks_.try_emplace(key, callback);
+void Webview::Impl::addCallback(const std::string& key, MessageCallback callback,
+                                CallbackThread thread) {
+  // Untyped callbacks receive the payload as compact JSON text.
+  auto shared = std::make_shared<MessageCallback>(std::move(callback));
+  addTypedCallback(
+      key,
+      [shared](json::TokenReader& reader, const json::Token& first) -> json::Invocation {
+        std::string payload;
+        if (!json::capture(reader, first, payload)) return {};
+        return [shared, payload = std::move(payload)] { (*shared)(payload); };
+      },
+      thread);
+}
+
+void Webview::Impl::addTypedCallback(const std::string& key, json::Binding binding,
+                                     CallbackThread thread) {
+  Callback callback{std::move(binding), nullptr};
+  if (thread == CallbackThread::kWorker && messageWorkers_) {
+    callback.queue = std::make_shared<utils::SerialQueue>(*messageWorkers_);
+  }
+  std::unique_lock lock(callbacksMutex_);
+  callbacks_.insert_or_assign(key, std::move(callback));
 }
 
-void Webview::addCallback(const std::string& key, MessageCallback callback) {
+void Webview::addCallback(const std::string& key, MessageCallback callback,
+                          CallbackThread thread) {
   if (!isReady()) return;
   auto script = "window['" + key + "'] = function(payload) { const key = '" + key + "';" +
                 R"(
@@ -77,46 +214,249 @@ void Webview::addCallback(const std::string& key, MessageCallback callback) {
                             });
                     }
                 )";
-  utils::dispatch<&Impl::addCallback>(impl_, key, callback);
-  injectScript(script);
+  utils::dispatch<&Impl::addCallback>(impl_, key, callback, thread);
+  utils::dispatch<&Impl::setCallbackScript>(impl_, key, script);
+  executeScript(script);
+}
+
+void Webview::addTypedCallback(const std::string& key, json::Binding binding,
+                               CallbackThread thread) {
+  if (!isReady()) return;
+  auto script = "window['" + key + "'] = function(...args) { const key = '" + key + "';" +
+                R"(
+                    window.webview.postMessage({
+                              key: key,
+                              payload: args,
+                            });
+                    }
+                )";
+  utils::dispatch<&Impl::addTypedCallback>(impl_, key, std::move(binding), thread);
+  utils::dispatch<&Impl::setCallbackScript>(impl_, key, script);
   executeScript(script);
 }
 
-void Webview::Impl::removeCallback(const std::string& key) { callbacks_.erase(key); }
+void Webview::Impl::removeCallback(const std::string& key) {
+  std::unique_lock lock(callbacksMutex_);
+  callbacks_.erase(key);
+}
 
 void Webview::removeCallback(const std::string& key) {
   if (!isReady()) return;
-  auto script = "delete window['" + key + "']";
   utils::dispatch<&Impl::removeCallback>(impl_, key);
-  injectScript(script);
-  executeScript(script);
+  utils::dispatch<&Impl::setCallbackScript>(impl_, key, std::string{});
+  executeScript("delete window['" + key + "']");
+}
+
+void Webview::Impl::setCallbackScript(const std::string& key, const std::string& script) {
+  // All callbacks are exposed by a single user script, rebuilt from the current set. Documents
+  // loaded later only run the callbacks that still exist, whatever was added and removed before.
+  if (script.empty()) {
+    if (callbackScripts_.erase(key) == 0) return;
+  } else {
+    callbackScripts_.insert_or_assign(key, script);
+  }
+
+  std::string bridge;
+  for (const auto& [name, source] : callbackScripts_) {
+    bridge += source + ";\n";
+  }
+  replaceCallbacksScript(bridge);
+}
+
+void Webview::Impl::postMessage(const std::string& message, const std::string& key) {
+  // Acknowledgements from the page arrive on the main thread, so only other threads may block.
+  if (outgoing_->push(message, key, !appHandler_->isMainThread())) {
+    appHandler_->postOnMainThread([weakSelf = weak_from_this()] {
+      if (auto self = weakSelf.lock()) self->flushOutgoing();
+    });
+  }
 }
 
-void Webview::postMessage(const std::string& message) {
+void Webview::postMessage(const std::string& message, const std::string& key) {
   if (!isReady()) return;
+  if (impl_->hasOutgoingQueue()) {
+    impl_->postMessage(message, key);
+    return;
+  }
   executeScript("window.webview.onMessage('" + message + "');");
 }
 
-void Webview::Impl::onMessage(const std::string& message) {
-  rapidjson::Document doc;
-  doc.Parse(message.c_str());
-  if (!doc.HasParseError() && doc.IsObject()) {
-    if (doc.HasMember("key") && doc.HasMember("payload")) {
-      const auto& key = doc["key"];
-      if (key.IsString()) {
-        std::string keyStr = key.GetString();
-        auto callback = callbacks_.find(keyStr);
-        if (callback != callbacks_.end()) {
-          const auto& payload = doc["payload"];
-          rapidjson::StringBuffer buffer;
-          rapidjson::Writer<rapidjson::StringBuffer> writer(buffer);
-          payload.Accept(writer);
-          callback->second(buffer.GetString());
+void Webview::Impl::flushOutgoing() {
+  // Sends everything queued as one batch. The page acknowledges it with a control message that
+  // flushes the next batch, or marks the queue idle when nothing is left.
+  auto batch = outgoing_->drain();
+  if (!batch.empty()) executeScript(js::createDeliveryScript(batch));
+}
+
+void Webview::Impl::onBridgeControl(bool delivered, std::size_t dropped) {
+  incomingDropped_ += dropped;
+  if (delivered && outgoing_) flushOutgoing();
+}
+
+void Webview::Impl::acknowledgeMessage() {
+  // Gives credit back to the page so it sends the messages it holds. Acknowledgements are
+  // batched into a single script per main loop iteration.
+  if (incomingCapacity_ == 0 || pendingAcks_++ > 0) return;
+  appHandler_->postOnMainThread([weakSelf = weak_from_this()] {
+    auto self = weakSelf.lock();
+    if (!self) return;
+    const auto count = self->pendingAcks_.exchange(0);
+    self->executeScript("window.webview.__ack(" + std::to_string(count) + ");");
+  });
+}
+
+BridgeQueueStats Webview::Impl::outgoingQueueStats() const {
+  if (!outgoing_) return {};
+  return {outgoing_->size(), outgoing_->dropped()};
+}
+
+BridgeQueueStats Webview::Impl::incomingQueueStats() const {
+  return {queuedMessages_.load(), incomingDropped_.load()};
+}
+
+std::size_t Webview::messageQueueDepth() const { return impl_ ? impl_->messageQueueDepth() : 0; }
+
+BridgeQueueStats Webview::outgoingQueueStats() const {
+  return impl_ ? impl_->outgoingQueueStats() : BridgeQueueStats{};
+}
+
+BridgeQueueStats Webview::incomingQueueStats() const {
+  return impl_ ? impl_->incomingQueueStats() : BridgeQueueStats{};
+}
+
+void Webview::Impl::applyMessageOptions(const WebviewOptions& options) {
+  const int workers = options.hasOption(WebviewOptions::kMessageWorkerThreads)
+                          ? options.getOption<int>(WebviewOptions::kMessageWorkerThreads)
+                          : 0;
+  if (workers > 0) {
+    messageWorkers_ = std::make_unique<utils::WorkerPool>(static_cast<std::size_t>(workers));
+    messageQueue_ = std::make_shared<utils::SerialQueue>(*messageWorkers_);
+  }
+
+  const int outgoingCapacity = options.getOption<int>(WebviewOptions::kOutgoingQueueCapacity);
+  if (outgoingCapacity > 0) {
+    outgoing_ = std::make_unique<utils::BoundedQueue<std::string>>(
+        static_cast<std::size_t>(outgoingCapacity),
+        queuePolicy(options, WebviewOptions::kOutgoingQueuePolicy));
+  }
+
+  const int incomingCapacity = options.getOption<int>(WebviewOptions::kIncomingQueueCapacity);
+  if (incomingCapacity > 0) {
+    incomingCapacity_ = static_cast<std::size_t>(incomingCapacity);
+    incomingPolicy_ = queuePolicy(options, WebviewOptions::kIncomingQueuePolicy);
+  }
+
+  if (outgoing_ || incomingCapacity_ > 0) {
+    callbacks_.insert_or_assign(
+        js::kBridgeControlKey,
+        Callback{json::bind<bool, std::size_t>([this](bool delivered, std::size_t dropped) {
+                   onBridgeControl(delivered, dropped);
+                 }),
+                 nullptr, true});
+  }
+}
+
+void Webview::Impl::onMessage(std::string message) {
+  if (!messageWorkers_) {
+    dispatchMessage(message);
+    return;
+  }
+
+  // Messages are parsed one after the other on the workers, which keeps them in arrival order.
+  ++queuedMessages_;
+  messageQueue_->post([this, message = std::move(message)] { dispatchMessage(message); });
+}
+
+Webview::Impl::DecodedMessage Webview::Impl::decodeMessage(const std::string& message) const {
+  // Single SAX pass over {"key": ..., "payload": ...}: once the key is known the payload is
+  // handed straight to the callback binding. Only when the payload precedes the key is it
+  // captured and parsed a second time.
+  DecodedMessage decoded;
+  std::string key;
+  std::string deferredPayload;
+  bool hasDeferredPayload = false;
+
+  std::shared_lock lock(callbacksMutex_);
+
+  // A message that is not one JSON object, trailing input included, is never dispatched.
+  const bool parsed = json::parse(message, [&](json::TokenReader& reader) {
+    json::Token token;
+    if (!reader.next(token) || token.type != json::TokenType::kStartObject) return false;
+
+    while (reader.next(token) && token.type == json::TokenType::kKey) {
+      if (token.string == "key") {
+        if (!reader.next(token) || token.type != json::TokenType::kString) return false;
+        key.assign(token.string);
+      } else if (token.string == "payload") {
+        if (!reader.next(token)) return false;
+        if (key.empty()) {
+          hasDeferredPayload = json::capture(reader, token, deferredPayload);
+          if (!hasDeferredPayload) return false;
+        } else if (auto callback = callbacks_.find(key); callback != callbacks_.end()) {
+          decoded = {callback->second.binding(reader, token), callback->second.queue,
+                     callback->second.internal};
+          if (!decoded.invocation) return false;
+        } else if (!json::skip(reader, token)) {
+          return false;
         }
+      } else if (!reader.next(token) || !json::skip(reader, token)) {
+        return false;
       }
     }
+    return token.type == json::TokenType::kEndObject;
+  });
+  if (!parsed) return {};
+
+  if (hasDeferredPayload && !key.empty()) {
+    if (auto callback = callbacks_.find(key); callback != callbacks_.end()) {
+      const bool bound = json::parse(deferredPayload, [&](json::TokenReader& reader) {
+        json::Token token;
+        if (!reader.next(token)) return false;
+        decoded = {callback->second.binding(reader, token), callback->second.queue,
+                   callback->second.internal};
+        return static_cast<bool>(decoded.invocation);
+      });
+      if (!bound) return {};
+    }
   }
-  events().emit(deskgui::event::WebviewOnMessage{message});
+
+  return decoded;
+}
+
+void Webview::Impl::dispatchMessage(const std::string& message) {
+  auto decoded = decodeMessage(message);
+  const bool internal = decoded.internal;
+
+  if (!messageWorkers_) {
+    if (decoded.invocation) decoded.invocation();
+    if (internal) return;
+    acknowledgeMessage();
+    events().emit(deskgui::event::WebviewOnMessage{message});
+    return;
+  }
+
+  // Worker callbacks run on their own serial queue, everything else goes back to the main
+  // thread in arrival order. The message is no longer queued once its callback has run.
+  const bool onWorker = decoded.invocation && decoded.queue;
+  if (onWorker) {
+    decoded.queue->post([this, invocation = std::move(decoded.invocation)] {
+      invocation();
+      --queuedMessages_;
+      acknowledgeMessage();
+    });
+  }
+
+  appHandler_->postOnMainThread([weakSelf = weak_from_this(), onWorker, internal,
+                                 invocation = std::move(decoded.invocation), message] {
+    auto self = weakSelf.lock();
+    if (!self) return;
+    if (!onWorker) {
+      if (invocation) invocation();
+      --self->queuedMessages_;
+      if (!internal) self->acknowledgeMessage();
+    }
+    if (!internal) self->events().emit(deskgui::event::WebviewOnMessage{message});
+  });
 }
 
 void Webview::Impl::applySchemeOptions(const WebviewOptions& options) {
@@ -185,8 +525,31 @@ void Webview::loadHTMLString(const std::string& html) {
 }
 
 void Webview::loadResources(Resources&& resources) {
+  loadResources(std::make_shared<const ResourcePack>(std::move(resources)));
+}
+
+void Webview::loadResources(const ResourceRegistry& registry) {
+  loadResources(std::make_shared<const ResourcePack>(registry));
+}
+
+void Webview::loadResources(std::shared_ptr<const ResourcePack> pack) {
+  if (!isReady()) return;
+  utils::dispatch<&Impl::loadResourcePack>(impl_, std::move(pack));
+}
+
+void Webview::mountResources(const std::string& layer, std::shared_ptr<const ResourcePack> pack) {
   if (!isReady()) return;
-  utils::dispatch<&Impl::loadResources>(impl_, std::move(resources));
+  utils::dispatch<&Impl::mountResources>(impl_, layer, std::move(pack));
+}
+
+void Webview::mountDirectory(const std::string& layer, const std::string& directory) {
+  if (!isReady()) return;
+  utils::dispatch<&Impl::mountDirectory>(impl_, layer, directory);
+}
+
+void Webview::unmountResources(const std::string& layer) {
+  if (!isReady()) return;
+  utils::dispatch<&Impl::unmountResources>(impl_, layer);
 }
 
 void Webview::serveResource(const std::string& resourceUrl) {
@@ -194,11 +557,475 @@ void Webview::serveResource(const std::string& resourceUrl) {
   utils::dispatch<&Impl::serveResource>(impl_, resourceUrl);
 }
 
+void Webview::serveDirectory(const std::string& mountPath, const std::string& directory) {
+  if (!isReady()) return;
+  utils::dispatch<&Impl::serveDirectory>(impl_, mountPath, directory);
+}
+
+void Webview::addRoute(const std::string& pattern, RouteHandler handler) {
+  if (!isReady()) return;
+  utils::dispatch<&Impl::addRoute>(impl_, pattern, std::move(handler));
+}
+
+void Webview::removeRoute(const std::string& pattern) {
+  if (!isReady()) return;
+  utils::dispatch<&Impl::removeRoute>(impl_, pattern);
+}
+
+void Webview::Impl::loadResourcePack(std::shared_ptr<const ResourcePack> pack) {
+  if (pack) {
+    replaceLayer({}, ResourceLayer{{}, std::move(pack), {}, {}, false});
+  } else {
+    replaceLayer({}, std::nullopt);
+  }
+  interceptResources();
+}
+
+void Webview::Impl::mountResources(const std::string& name,
+                                   std::shared_ptr<const ResourcePack> pack) {
+  if (name.empty()) throw std::invalid_argument("resource layers need a name");
+  if (!pack) {
+    replaceLayer(name, std::nullopt);
+    return;
+  }
+  replaceLayer(name, ResourceLayer{name, std::move(pack), {}, {}, false});
+  interceptResources();
+}
+
+void Webview::Impl::mountDirectory(const std::string& name, const std::string& directory) {
+  if (name.empty()) throw std::invalid_argument("resource layers need a name");
+  std::error_code error;
+  const auto root = std::filesystem::u8path(directory);
+  if (!std::filesystem::is_directory(root, error)) {
+    throw std::invalid_argument(directory + " is not a directory");
+  }
+  replaceLayer(name,
+               ResourceLayer{name, nullptr, std::filesystem::absolute(root, error), {}, false});
+  resourceWorkers();
+  interceptResources();
+}
+
+void Webview::Impl::unmountResources(const std::string& name) {
+  if (!name.empty()) replaceLayer(name, std::nullopt);
+}
+
+void Webview::Impl::replaceLayer(const std::string& name, std::optional<ResourceLayer> layer,
+                                 bool served) {
+  // The layers are copied, not the packs: requests in flight keep the previous list.
+  const auto current = std::atomic_load(&layers_);
+  auto layers = current ? std::make_shared<ResourceLayers>(*current)
+                        : std::make_shared<ResourceLayers>();
+  auto it = std::find_if(layers->begin(), layers->end(), [&](const ResourceLayer& existing) {
+    return existing.served == served && existing.name == name;
+  });
+  if (it != layers->end() && layer) {
+    *it = std::move(*layer);
+  } else if (it != layers->end()) {
+    layers->erase(it);
+  } else if (layer) {
+    // New layers go over the others. The pack of loadResources goes below them and the served
+    // directories below it, the longest path first.
+    auto position = layers->begin();
+    if (served) {
+      position = std::find_if(layers->begin(), layers->end(), [&name](const ResourceLayer& other) {
+        return other.served && other.path.size() < name.size();
+      });
+    } else if (name.empty()) {
+      position = std::find_if(layers->begin(), layers->end(),
+                              [](const ResourceLayer& other) { return other.served; });
+    }
+    layers->insert(position, std::move(*layer));
+  }
+  std::atomic_store(&layers_, std::shared_ptr<const ResourceLayers>(std::move(layers)));
+}
+
+std::shared_ptr<const ResourcePack> Webview::Impl::resourcePack() const {
+  const auto layers = std::atomic_load(&layers_);
+  if (!layers) return nullptr;
+  const auto base = std::find_if(layers->begin(), layers->end(), [](const ResourceLayer& layer) {
+    return layer.name.empty() && !layer.served;
+  });
+  return base != layers->end() ? base->pack : nullptr;
+}
+
+void Webview::Impl::serveDirectory(const std::string& mountPath, const std::string& directory) {
+  std::string path = mountPath;
+  path.erase(0, path.find_first_not_of('/'));
+  if (!path.empty() && path.back() != '/') path += '/';
+  if (directory.empty()) {
+    replaceLayer(path, std::nullopt, true);
+    return;
+  }
+
+  std::error_code error;
+  const auto root = std::filesystem::u8path(directory);
+  if (!std::filesystem::is_directory(root, error)) {
+    throw std::invalid_argument(directory + " is not a directory");
+  }
+  replaceLayer(path,
+               ResourceLayer{path, nullptr, std::filesystem::absolute(root, error), path, true},
+               true);
+  resourceWorkers();
+  interceptResources();
+}
+
+void Webview::Impl::addRoute(const std::string& pattern, RouteHandler handler) {
+  removeRoute(pattern);
+  routes_.push_back({pattern.substr(std::min(pattern.find_first_not_of('/'), pattern.size())),
+                     std::move(handler)});
+  resourceWorkers();
+  interceptResources();
+}
+
+void Webview::Impl::removeRoute(const std::string& pattern) {
+  const auto path = pattern.substr(std::min(pattern.find_first_not_of('/'), pattern.size()));
+  routes_.erase(std::remove_if(routes_.begin(), routes_.end(),
+                               [&path](const Route& route) { return route.pattern == path; }),
+                routes_.end());
+}
+
+utils::WorkerPool& Webview::Impl::resourceWorkers() {
+  if (!resourceWorkers_) {
+    resourceWorkers_ = std::make_unique<utils::WorkerPool>(resourceWorkerThreads_);
+  }
+  return *resourceWorkers_;
+}
+
+void Webview::Impl::stopResourceWorkers() {
+  // A handler writing to a page that no longer reads would block the join of its worker.
+  streams_->cancel();
+  resourceWorkers_.reset();
+}
+
+void Webview::Impl::clearResources() {
+  std::atomic_store(&layers_, std::shared_ptr<const ResourceLayers>());
+  {
+    std::lock_guard<std::mutex> lock(decodedResourcesMutex_);
+    decodedResources_->clear();
+  }
+  {
+    std::lock_guard<std::mutex> lock(cachedFilesMutex_);
+    cachedFiles_->clear();
+  }
+  stopInterceptingResources();
+}
+
+std::optional<std::string_view> Webview::Impl::requestPath(std::string_view url) const {
+  // The origin is stripped once per request; the query and fragment do not select a resource.
+  if (url.substr(0, origin_.size()) != origin_) return std::nullopt;
+  url.remove_prefix(origin_.size());
+  return url.substr(0, url.find_first_of("?#"));
+}
+
+std::optional<ResourceContent> Webview::Impl::decodedContent(const Resource& resource) {
+  if (resource.encoding.empty()) return resource.content;
+
+  // Webviews cannot rely on Content-Encoding for custom schemes, compressed resources are
+  // decoded here and the most recently used ones are kept.
+  std::lock_guard<std::mutex> lock(decodedResourcesMutex_);
+  const auto* key = resource.content.data();
+  if (auto cached = decodedResources_->get(key);
+      cached && cached->source.size() == resource.content.size()) {
+    return cached->decoded;
+  }
+
+  auto decoded = utils::decompress(resource.encoding, resource.content.data(),
+                                   resource.content.size());
+  if (!decoded) return std::nullopt;
+
+  const auto size = decoded->size();
+  ResourceContent content(std::move(*decoded));
+  decodedResources_->put(key, {resource.content, content}, size);
+  return content;
+}
+
+void Webview::Impl::handleResourceRequest(ResourceRequest request, ResourceResponder respond) {
+  // Every request is counted once its response reaches the webview, whoever answered it.
+  respond = [weakSelf = weak_from_this(), url = request.url,
+             started = std::chrono::steady_clock::now(),
+             respond = std::move(respond)](std::optional<ResourceResponse> response) {
+    if (auto self = weakSelf.lock()) self->recordResourceRequest(url, started, response);
+    respond(std::move(response));
+  };
+
+  if (handleRoute(request, respond)) return;
+
+  // Packs above the first disk layer answer right away.
+  const auto layers = std::atomic_load(&layers_);
+  std::size_t layer = 0;
+  for (; layers && layer < layers->size() && (*layers)[layer].pack; ++layer) {
+    if (auto response = respondToResource(request, *(*layers)[layer].pack)) {
+      respond(std::move(response));
+      return;
+    }
+  }
+
+  if (!layers || layer == layers->size()) {
+    respond(std::nullopt);
+    return;
+  }
+
+  // Files are read on the resource workers, which also look up the layers below the first disk
+  // layer, and the response is completed on the main thread.
+  resourceWorkers().post([this, request = std::move(request), layers, layer,
+                          respond = std::move(respond)]() mutable {
+    utils::Task writeBody;
+    auto response = respondFromLayers(request, *layers, layer, writeBody);
+    appHandler_->postOnMainThread(
+        [response = std::move(response), respond = std::move(respond)]() mutable {
+          respond(std::move(response));
+        });
+    // A streamed file is written by the worker that opened it while the page reads it.
+    if (writeBody) writeBody();
+  });
+}
+
+std::optional<Webview::Impl::ResourceResponse> Webview::Impl::respondFromLayers(
+    const ResourceRequest& request, const ResourceLayers& layers, std::size_t first,
+    utils::Task& writeBody) {
+  const auto path = requestPath(request.url);
+  if (!path) return std::nullopt;
+
+  for (std::size_t i = first; i < layers.size(); ++i) {
+    const auto& layer = layers[i];
+    if (layer.pack) {
+      if (auto response = respondToResource(request, *layer.pack)) return response;
+      continue;
+    }
+    // Disk layers mirror the origin below their path, a missing file falls through to the layers
+    // below. Escaped dots and slashes are decoded before the check, no request leaves the
+    // directory.
+    if (path->substr(0, layer.path.size()) != layer.path) continue;
+    const auto relative = utils::percentDecode(path->substr(layer.path.size()));
+    if (!relative || !utils::isContainedPath(*relative)) continue;
+    auto file = layer.directory / std::filesystem::u8path(*relative);
+    if (auto response = respondToFile(request, std::move(file), writeBody)) return response;
+  }
+  return std::nullopt;
+}
+
+void Webview::Impl::recordResourceRequest(const std::string& url,
+                                          std::chrono::steady_clock::time_point started,
+                                          const std::optional<ResourceResponse>& response) {
+  using std::chrono::microseconds;
+  const auto latency
+      = std::chrono::duration_cast<microseconds>(std::chrono::steady_clock::now() - started);
+  // Requests outside the origin are counted by their whole URL, queries left out as well.
+  const auto path = requestPath(url).value_or(
+      std::string_view(url).substr(0, url.find_first_of("?#")));
+  {
+    std::lock_guard<std::mutex> lock(resourceStatsMutex_);
+    auto& paths = resourceStats_.paths;
+    auto entry = paths.find(std::string(path));
+    if (entry == paths.end()) {
+      const auto key = paths.size() < ResourceStats::kMaxPaths ? path : ResourceStats::kOtherPaths;
+      entry = paths.try_emplace(std::string(key)).first;
+    }
+    auto& stats = entry->second;
+    const int status = response ? response->status : 404;
+    if (status == 404) {
+      ++stats.misses;
+      ++resourceStats_.misses;
+    } else if (status >= 400) {
+      ++stats.errors;
+      ++resourceStats_.errors;
+    } else {
+      ++stats.hits;
+      ++resourceStats_.hits;
+    }
+    // Streamed bodies are written after the response is handed over, their size is unknown here.
+    const std::uint64_t bytes = response && !response->stream ? response->body.size() : 0;
+    stats.bytes += bytes;
+    resourceStats_.bytes += bytes;
+    stats.totalLatency += latency;
+    stats.maxLatency = std::max(stats.maxLatency, latency);
+  }
+
+  if (slowResourceThreshold_.count() > 0 && latency >= slowResourceThreshold_) {
+    events_.emit(event::WebviewSlowResource(url, latency));
+  }
+}
+
+ResourceStats Webview::Impl::resourceStats() const {
+  std::lock_guard<std::mutex> lock(resourceStatsMutex_);
+  return resourceStats_;
+}
+
+ResourceStats Webview::resourceStats() const {
+  return impl_ ? impl_->resourceStats() : ResourceStats{};
+}
+
+bool Webview::Impl::handleRoute(ResourceRequest& request, ResourceResponder& respond) {
+  if (routes_.empty()) return false;
+  const auto path = requestPath(request.url);
+  if (!path) return false;
+
+  for (const auto& route : routes_) {
+    std::map<std::string, std::string> params;
+    if (!utils::matchRoute(route.pattern, *path, params)) continue;
+
+    RouteRequest routeRequest;
+    routeRequest.method = std::move(request.method);
+    routeRequest.path = std::string(*path);
+    if (const auto query = request.url.find('?'); query != std::string::npos) {
+      routeRequest.query = request.url.substr(query + 1, request.url.find('#', query) - query - 1);
+    }
+    routeRequest.body = std::move(request.body);
+    routeRequest.params = std::move(params);
+    routeRequest.url = std::move(request.url);
+
+    // Handlers run on the resource workers, a handler that throws answers 500.
+    auto state = std::make_shared<RouteResponse::State>(
+        std::move(respond), appHandler_, request.streaming ? streams_ : nullptr);
+    resourceWorkers().post([handler = route.handler, routeRequest = std::move(routeRequest),
+                            state = std::move(state)]() mutable {
+      try {
+        handler(routeRequest, RouteResponse(state));
+      } catch (...) {
+        state->fail();
+      }
+      state.reset();
+    });
+    return true;
+  }
+  return false;
+}
+
+std::optional<Webview::Impl::ResourceResponse> Webview::Impl::respondToResource(
+    const ResourceRequest& request, const ResourcePack& pack) {
+  const auto path = requestPath(request.url);
+  if (!path) return std::nullopt;
+  const Resource* resource = pack.find(*path);
+  if (!resource) return std::nullopt;
+
+  // Pages get the preload links of their pack, their tag tells apart packs listing others.
+  const auto links = utils::isHtml(resource->mime) ? preloadLinks(pack, *path) : std::string{};
+  std::string tag;
+  if (!resource->hash.empty()) {
+    std::ostringstream hash;
+    hash << resource->hash;
+    if (!links.empty()) hash << '-' << std::hex << utils::stableHash(links);
+    tag = utils::entityTag(hash.str());
+  }
+
+  ResourceResponse response;
+  response.mime = resource->mime;
+  response.headers.emplace_back("Content-Type", resource->mime);
+  if (respondNotModified(request, resource->scheme, tag, response)) return response;
+
+  auto content = decodedContent(*resource);
+  if (!content) return std::nullopt;
+  if (!links.empty()) {
+    const auto page = utils::insertIntoHead(
+        {reinterpret_cast<const char*>(content->data()), content->size()}, links);
+    content = ResourceContent(page.begin(), page.end());
+  }
+  const auto slice = [&content, &response](std::size_t offset, std::size_t length) {
+    response.body = content->slice(offset, length);
+    return true;
+  };
+  respondWithRange(request, content->size(), slice, response);
+  return response;
+}
+
+std::string Webview::Impl::preloadLinks(const ResourcePack& pack, std::string_view page) const {
+  std::string links;
+  for (const auto& path : pack.preload()) {
+    const auto* resource = path == page ? nullptr : pack.find(path);
+    if (resource) links += utils::preloadLink(origin_ + path, resource->mime);
+  }
+  return links;
+}
+
+std::optional<Webview::Impl::ResourceResponse> Webview::Impl::respondToFile(
+    const ResourceRequest& request, std::filesystem::path file, utils::Task& writeBody) {
+  std::error_code error;
+  if (std::filesystem::is_directory(file, error)) file /= "index.html";
+  const auto size = std::filesystem::file_size(file, error);
+  if (error) return std::nullopt;
+  const auto modified = std::filesystem::last_write_time(file, error);
+  if (error) return std::nullopt;
+
+  ResourceResponse response;
+  response.mime = utils::mimeType(file.extension().string());
+  response.headers.emplace_back("Content-Type", response.mime);
+
+  // Files can change at any time, their tag is derived from their size and modification time.
+  std::ostringstream tag;
+  tag << '"' << std::hex << size << '-' << modified.time_since_epoch().count() << '"';
+  if (respondNotModified(request, file.generic_string(), tag.str(), response)) return response;
+
+  const auto key = file.string();
+  std::optional<ResourceContent> cached;
+  {
+    std::lock_guard<std::mutex> lock(cachedFilesMutex_);
+    const auto entry = cachedFiles_->get(key);
+    if (entry && entry->size == size && entry->modified == modified) cached = entry->content;
+  }
+
+  // Small whole files are kept for the next request, ranges of files not kept are read on their
+  // own. Larger files are streamed on platforms that read bodies while they are written.
+  const bool streamed = size > kMaxCachedFileSize && request.streaming;
+  const auto read = [&](std::size_t offset, std::size_t length) {
+    if (cached) {
+      response.body = cached->slice(offset, length);
+      return true;
+    }
+    if (streamed) {
+      auto input = std::make_shared<std::ifstream>(file, std::ios::binary);
+      if (!input->seekg(static_cast<std::streamoff>(offset))) return false;
+      auto body = streams_->create(kFileStreamCapacity);
+      writeBody = [input, body, length]() { streamFile(*input, length, *body); };
+      response.stream = std::move(body);
+      return true;
+    }
+    auto content = readFile(file, offset, length);
+    if (!content) return false;
+    if (length == size && size <= kMaxCachedFileSize) {
+      std::lock_guard<std::mutex> lock(cachedFilesMutex_);
+      cachedFiles_->put(key, {size, modified, *content}, length);
+    }
+    response.body = std::move(*content);
+    return true;
+  };
+  if (!respondWithRange(request, static_cast<std::size_t>(size), read, response)) {
+    return std::nullopt;
+  }
+  return response;
+}
+
+void Webview::Impl::applyResourceOptions(const WebviewOptions& options) {
+  constexpr std::size_t kDefaultCacheSize = 32 * 1024 * 1024;
+  const std::size_t cacheSize
+      = options.hasOption(WebviewOptions::kResourceCacheSize)
+            ? static_cast<std::size_t>(options.getOption<int>(WebviewOptions::kResourceCacheSize))
+            : kDefaultCacheSize;
+  decodedResources_
+      = std::make_unique<utils::LruCache<const std::uint8_t*, DecodedContent>>(cacheSize);
+  cachedFiles_ = std::make_unique<utils::LruCache<std::string, CachedFile>>(cacheSize);
+
+  constexpr std::size_t kDefaultWorkerThreads = 2;
+  resourceWorkerThreads_
+      = options.hasOption(WebviewOptions::kResourceWorkerThreads)
+            ? static_cast<std::size_t>(
+                std::max(1, options.getOption<int>(WebviewOptions::kResourceWorkerThreads)))
+            : kDefaultWorkerThreads;
+
+  if (options.hasOption(WebviewOptions::kSlowResourceThreshold)) {
+    slowResourceThreshold_ = std::chrono::milliseconds(
+        std::max(0, options.getOption<int>(WebviewOptions::kSlowResourceThreshold)));
+  }
+}
+
 void Webview::clearResources() {
   if (!isReady()) return;
   utils::dispatch<&Impl::clearResources>(impl_);
 }
 
+std::shared_ptr<const ResourcePack> Webview::resourcePack() const {
+  return impl_ ? impl_->resourcePack() : nullptr;
+}
+
 std::string Webview::getUrl() {
   if (!isReady()) return {};
   return utils::dispatch<&Impl::getUrl>(impl_);
@@ -214,3 +1041,11 @@ void Webview::executeScript(const std::string& script) {
   if (!isReady()) return;
   utils::dispatch<&Impl::executeScript>(impl_, script);
 }
+
+void Webview::evaluate(const std::string& script, ScriptCallback callback) {
+  if (!isReady()) {
+    callback(false, "Webview is not ready");
+    return;
+  }
+  utils::dispatch<&Impl::evaluateScript>(impl_, script, std::move(callback));
+}
@@ -12,12 +12,15 @@ using namespace deskgui;
 
 Webview* Window::Impl::createWebview(const std::string& name, const WebviewOptions& options) {
   try {
-    auto result = webviews_.emplace(
-        name, std::unique_ptr<Webview>(new Webview(name, appHandler_, getContentView(), options)));
-    if (result.second) {
-      return result.first->second.get();
+    if (webviews_.find(name) != webviews_.end()) {
+      return nullptr;
     }
-    return nullptr;
+    // A webview of the pool of the application is ready without waiting for a web process.
+    auto webview = appHandler_->takePooledWebview(name, getContentView(), options);
+    if (!webview) {
+      webview.reset(new Webview(name, appHandler_, getContentView(), options));
+    }
+    return webviews_.emplace(name, std::move(webview)).first->second.get();
   } catch ([[maybe_unused]] const std::exception& e) {
     return nullptr;
   }
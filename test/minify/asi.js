@@ -0,0 +1,11 @@
+let a = b
+(c)
+let i = 0
+;[1, 2].forEach(run)
+function f() {
+  return
+  value
+}
+let x = y
+++z
+const s = 'single ' + "double"
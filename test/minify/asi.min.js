@@ -0,0 +1,8 @@
+let a=b
+(c)
+let i=0;[1,2].forEach(run)
+function f(){return
+value}
+let x=y
+++z
+const s='single '+"double"
\ No newline at end of file
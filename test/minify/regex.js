@@ -0,0 +1,7 @@
+// Regular expression literals next to divisions.
+const pattern = /[/"'`]+\/*/g;
+const ratio = width / height / 2;
+const next = count++ / 2;
+if (/^\s*$/.test(line)) skip();
+return /a   b/.source;
+const halves = (total) / 2;
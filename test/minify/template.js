@@ -0,0 +1,5 @@
+const name = `deskgui`;
+const greeting = `Hello,   ${name}!
+  // not a comment
+  /* neither */ ${`nested ${ value  +  1 }`}`;
+const tagged = html`<p class="a   b">${ text }</p>`;
@@ -0,0 +1,3 @@
+const name=`deskgui`;const greeting=`Hello,   ${name}!
+  // not a comment
+  /* neither */ ${`nested ${ value  +  1 }`}`;const tagged=html`<p class="a   b">${ text }</p>`;
\ No newline at end of file
@@ -0,0 +1,45 @@
+# deskgui - A powerful and flexible C++ library to create web-based desktop applications.
+# Copyright (c) 2023 deskgui
+# MIT License
+
+'''
+Golden tests of the built-in minifiers of the resource compiler: every file of the minify folder
+is minified and compared with its ".min" counterpart. The external tools are never run, their
+output depends on the installed versions. Pass --update to rewrite the expected files.
+'''
+
+import os
+import sys
+
+current_dir = os.path.dirname(os.path.abspath(__file__))
+sys.path.insert(0, os.path.join(current_dir, "..", "cmake", "resource_compiler"))
+
+from minify import MINIFIERS
+
+def main():
+    update = "--update" in sys.argv[1:]
+    golden_dir = os.path.join(current_dir, "minify")
+    failures = 0
+    for name in sorted(os.listdir(golden_dir)):
+        stem, extension = os.path.splitext(name)
+        if stem.endswith(".min") or extension not in MINIFIERS:
+            continue
+        with open(os.path.join(golden_dir, name), "r", encoding="utf-8", newline="") as source:
+            minified = MINIFIERS[extension][0](source.read())
+
+        expected_path = os.path.join(golden_dir, f"{stem}.min{extension}")
+        if update:
+            with open(expected_path, "w", encoding="utf-8", newline="") as expected:
+                expected.write(minified)
+            continue
+        with open(expected_path, "r", encoding="utf-8", newline="") as expected:
+            expected_text = expected.read()
+        if minified != expected_text:
+            failures += 1
+            print(f"{name}: expected\n{expected_text!r}\ngot\n{minified!r}\n")
+
+    print(f"minify: {failures} failure(s)" if failures else "minify: all golden files match")
+    return 1 if failures else 0
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1 @@
+document.title = 'app';
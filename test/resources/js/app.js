@@ -0,0 +1 @@
+console.log('js/app.js');
@@ -0,0 +1,83 @@
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "catch2/catch_all.hpp"
+#include "utils/bounded_queue.h"
+
+using namespace deskgui;
+using namespace deskgui::utils;
+
+TEST_CASE("BoundedQueue wakes its consumer once per batch") {
+  BoundedQueue<int> queue(0, QueuePolicy::kDropOldest);
+
+  CHECK(queue.push(1, "", false));
+  CHECK_FALSE(queue.push(2, "", false));
+  CHECK(queue.size() == 2);
+
+  CHECK(queue.drain() == std::vector<int>{1, 2});
+  CHECK_FALSE(queue.push(3, "", false));
+  CHECK(queue.drain() == std::vector<int>{3});
+  CHECK(queue.drain().empty());
+
+  // Idle again once a drain returned nothing.
+  CHECK(queue.push(4, "", false));
+  CHECK(queue.dropped() == 0);
+}
+
+TEST_CASE("BoundedQueue applies its policy when full") {
+  SECTION("Drop oldest keeps the newest items") {
+    BoundedQueue<int> queue(2, QueuePolicy::kDropOldest);
+    for (int i = 1; i <= 5; ++i) queue.push(i, "", false);
+    CHECK(queue.size() == 2);
+    CHECK(queue.dropped() == 3);
+    CHECK(queue.drain() == std::vector<int>{4, 5});
+  }
+
+  SECTION("Coalesce replaces the item with the same key in place") {
+    BoundedQueue<std::string> queue(3, QueuePolicy::kCoalesce);
+    queue.push("a1", "a", false);
+    queue.push("b1", "b", false);
+    queue.push("a2", "a", false);
+    queue.push("x", "", false);
+    CHECK(queue.dropped() == 1);
+    CHECK(queue.drain() == std::vector<std::string>{"a2", "b1", "x"});
+  }
+
+  SECTION("Coalesce drops the oldest item for new keys") {
+    BoundedQueue<std::string> queue(2, QueuePolicy::kCoalesce);
+    queue.push("a", "a", false);
+    queue.push("b", "b", false);
+    queue.push("c", "c", false);
+    CHECK(queue.dropped() == 1);
+    CHECK(queue.drain() == std::vector<std::string>{"b", "c"});
+  }
+
+  SECTION("Block grows past the capacity when the producer may not wait") {
+    BoundedQueue<int> queue(1, QueuePolicy::kBlock);
+    queue.push(1, "", false);
+    queue.push(2, "", false);
+    CHECK(queue.size() == 2);
+    CHECK(queue.dropped() == 0);
+  }
+
+  SECTION("Block waits for the consumer") {
+    BoundedQueue<int> queue(1, QueuePolicy::kBlock);
+    queue.push(1, "", true);
+
+    std::atomic<bool> pushed{false};
+    std::thread producer([&queue, &pushed] {
+      queue.push(2, "", true);
+      pushed = true;
+    });
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    CHECK_FALSE(pushed);
+
+    CHECK(queue.drain() == std::vector<int>{1});
+    producer.join();
+    CHECK(pushed);
+    CHECK(queue.drain() == std::vector<int>{2});
+  }
+}
@@ -0,0 +1,110 @@
+#include <chrono>
+#include <future>
+#include <string>
+#include <thread>
+
+#include "catch2/catch_all.hpp"
+#include "utils/chunked_body.h"
+
+using namespace deskgui::utils;
+
+namespace {
+
+  std::string readAll(ChunkedBody& body, std::size_t bufferSize = 4) {
+    std::string content;
+    std::string buffer(bufferSize, '\0');
+    auto* data = reinterpret_cast<std::uint8_t*>(buffer.data());
+    while (const auto size = body.read(data, bufferSize)) {
+      content.append(buffer, 0, size);
+    }
+    return content;
+  }
+
+  bool blocked(const std::future<bool>& future) {
+    return future.wait_for(std::chrono::milliseconds(50)) == std::future_status::timeout;
+  }
+
+}  // namespace
+
+TEST_CASE("ChunkedBody hands the written chunks to the reader") {
+  ChunkedBody body(1024);
+
+  SECTION("Chunks are read in order across buffer boundaries") {
+    CHECK(body.write("hello "));
+    CHECK(body.write(""));
+    CHECK(body.write("world"));
+    body.close();
+    CHECK(readAll(body, 4) == "hello world");
+  }
+
+  SECTION("Writes fail once the body is closed") {
+    body.close();
+    CHECK_FALSE(body.write("late"));
+    CHECK(readAll(body).empty());
+  }
+
+  SECTION("Reader waits for the writer") {
+    auto reader = std::async(std::launch::async, [&body] { return readAll(body); });
+    CHECK(body.write("abc"));
+    CHECK(body.write("def"));
+    body.close();
+    CHECK(reader.get() == "abcdef");
+  }
+}
+
+TEST_CASE("ChunkedBody pushes back on the writer") {
+  ChunkedBody body(8);
+  CHECK(body.write("12345678"));
+
+  auto writer = std::async(std::launch::async, [&body] { return body.write("9"); });
+  CHECK(blocked(writer));
+
+  std::uint8_t buffer[4];
+  CHECK(body.read(buffer, sizeof(buffer)) == 4);
+  CHECK(writer.get());
+  body.close();
+  CHECK(readAll(body) == "56789");
+}
+
+TEST_CASE("ChunkedBody cancellation wakes both sides") {
+  SECTION("Blocked writer fails") {
+    ChunkedBody body(4);
+    CHECK(body.write("1234"));
+    auto writer = std::async(std::launch::async, [&body] { return body.write("5"); });
+    CHECK(blocked(writer));
+    body.cancel();
+    CHECK_FALSE(writer.get());
+    CHECK(body.cancelled());
+  }
+
+  SECTION("Blocked reader gets nothing") {
+    ChunkedBody body(4);
+    auto reader = std::async(std::launch::async, [&body] { return readAll(body); });
+    body.cancel();
+    CHECK(reader.get().empty());
+  }
+
+  SECTION("Unread chunks are dropped") {
+    ChunkedBody body(64);
+    CHECK(body.write("unread"));
+    body.cancel();
+    CHECK_FALSE(body.write("more"));
+    CHECK(readAll(body).empty());
+  }
+}
+
+TEST_CASE("ChunkedBodies cancels the bodies still alive") {
+  ChunkedBodies bodies;
+  auto body = bodies.create(4);
+  bodies.create(4);  // Released at once, nothing to cancel.
+  CHECK(body->write("1234"));
+
+  auto writer = std::async(std::launch::async, [&body] { return body->write("5"); });
+  CHECK(blocked(writer));
+  bodies.cancel();
+  CHECK_FALSE(writer.get());
+
+  const auto late = bodies.create(4);
+  CHECK(late->cancelled());
+  CHECK_FALSE(late->write("x"));
+}
@@ -0,0 +1,102 @@
+#include <string>
+#include <string_view>
+
+#include "catch2/catch_all.hpp"
+#include "utils/decompress.h"
+
+using namespace deskgui::utils;
+
+namespace {
+
+#if defined(DESKGUI_HAS_ZLIB) || defined(DESKGUI_HAS_ZSTD)
+  std::string_view text(const Bytes& bytes) {
+    return {reinterpret_cast<const char*>(bytes.data()), bytes.size()};
+  }
+#endif
+
+#ifdef DESKGUI_HAS_ZLIB
+  Bytes gzip(std::string_view input) {
+    z_stream stream{};
+    deflateInit2(&stream, Z_BEST_COMPRESSION, Z_DEFLATED, 16 + MAX_WBITS, 8, Z_DEFAULT_STRATEGY);
+    Bytes output(deflateBound(&stream, static_cast<uLong>(input.size())));
+    stream.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(input.data()));
+    stream.avail_in = static_cast<uInt>(input.size());
+    stream.next_out = output.data();
+    stream.avail_out = static_cast<uInt>(output.size());
+    deflate(&stream, Z_FINISH);
+    output.resize(stream.total_out);
+    deflateEnd(&stream);
+    return output;
+  }
+#endif
+
+}  // namespace
+
+TEST_CASE("decompress rejects unknown encodings") {
+  const Bytes data{'a', 'b', 'c'};
+  CHECK_FALSE(decompress("identity", data.data(), data.size()).has_value());
+  CHECK_FALSE(decompress("deflate", data.data(), data.size()).has_value());
+}
+
+#ifdef DESKGUI_HAS_ZLIB
+TEST_CASE("decompress decodes gzip") {
+  SECTION("Round trip") {
+    const auto compressed = gzip("<html><body>hello</body></html>");
+    const auto decoded = decompress("gzip", compressed.data(), compressed.size());
+    REQUIRE(decoded.has_value());
+    CHECK(text(*decoded) == "<html><body>hello</body></html>");
+  }
+
+  SECTION("Output larger than one chunk") {
+    const std::string page(3 * detail::kDecompressChunk + 17, 'x');
+    const auto compressed = gzip(page);
+    const auto decoded = decompress("gzip", compressed.data(), compressed.size());
+    REQUIRE(decoded.has_value());
+    CHECK(text(*decoded) == page);
+  }
+
+  SECTION("Empty input") {
+    const auto compressed = gzip("");
+    const auto decoded = decompress("gzip", compressed.data(), compressed.size());
+    REQUIRE(decoded.has_value());
+    CHECK(decoded->empty());
+  }
+
+  SECTION("Truncated stream") {
+    const auto compressed = gzip("<html><body>hello</body></html>");
+    CHECK_FALSE(decompress("gzip", compressed.data(), compressed.size() / 2).has_value());
+  }
+
+  SECTION("Corrupt header") {
+    auto compressed = gzip("<html><body>hello</body></html>");
+    compressed[0] = 0;
+    CHECK_FALSE(decompress("gzip", compressed.data(), compressed.size()).has_value());
+  }
+
+  SECTION("Corrupt checksum") {
+    auto compressed = gzip("<html><body>hello</body></html>");
+    compressed[compressed.size() - 6] ^= 0xff;
+    CHECK_FALSE(decompress("gzip", compressed.data(), compressed.size()).has_value());
+  }
+
+  SECTION("Not compressed at all") {
+    const std::string_view plain = "<html><body>hello</body></html>";
+    const auto* data = reinterpret_cast<const std::uint8_t*>(plain.data());
+    CHECK_FALSE(decompress("gzip", data, plain.size()).has_value());
+  }
+}
+#endif
+
+#ifdef DESKGUI_HAS_ZSTD
+TEST_CASE("decompress decodes zstd") {
+  const std::string page(2 * detail::kDecompressChunk + 5, 'z');
+  Bytes compressed(ZSTD_compressBound(page.size()));
+  compressed.resize(
+      ZSTD_compress(compressed.data(), compressed.size(), page.data(), page.size(), 3));
+
+  const auto decoded = decompress("zstd", compressed.data(), compressed.size());
+  REQUIRE(decoded.has_value());
+  CHECK(text(*decoded) == page);
+  CHECK_FALSE(decompress("zstd", compressed.data(), compressed.size() - 1).has_value());
+}
+#endif
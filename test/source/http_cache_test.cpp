@@ -0,0 +1,53 @@
+#include "catch2/catch_all.hpp"
+#include "utils/http_cache.h"
+
+using namespace deskgui::utils;
+
+TEST_CASE("matchesEntityTag compares If-None-Match values") {
+  const auto tag = entityTag("3f2a9c1b");
+  CHECK(tag == "\"3f2a9c1b\"");
+
+  SECTION("Same tag") { CHECK(matchesEntityTag("\"3f2a9c1b\"", tag)); }
+
+  SECTION("Weak tags match with the weak comparison") {
+    CHECK(matchesEntityTag("W/\"3f2a9c1b\"", tag));
+  }
+
+  SECTION("Wildcard matches any tag") { CHECK(matchesEntityTag("*", tag)); }
+
+  SECTION("Any tag of a list matches") {
+    CHECK(matchesEntityTag("\"aaaa\", W/\"3f2a9c1b\"", tag));
+    CHECK(matchesEntityTag("\"aaaa\",\"3f2a9c1b\" ", tag));
+    CHECK(matchesEntityTag("\"aaaa\", *", tag));
+  }
+
+  SECTION("Other tags do not match") {
+    CHECK_FALSE(matchesEntityTag("", tag));
+    CHECK_FALSE(matchesEntityTag("\"aaaa\"", tag));
+    CHECK_FALSE(matchesEntityTag("\"aaaa\", \"bbbb\"", tag));
+    CHECK_FALSE(matchesEntityTag("3f2a9c1b", tag));
+    CHECK_FALSE(matchesEntityTag("\"3f2a9c1b", tag));
+    CHECK_FALSE(matchesEntityTag("w/\"3f2a9c1b\"", tag));
+  }
+}
+
+TEST_CASE("isContentHashedPath tells apart the names carrying a content hash") {
+  SECTION("Hashed names") {
+    CHECK(isContentHashedPath("app.3f2a9c1b.js"));
+    CHECK(isContentHashedPath("assets/index-D8KjL2hW.css"));
+    CHECK(isContentHashedPath("/fonts/inter-var.4f3b21aa.woff2"));
+    CHECK(isContentHashedPath("chunk.0123456789abcdef0123456789abcdef.js"));
+  }
+
+  SECTION("Unhashed names") {
+    CHECK_FALSE(isContentHashedPath("index.html"));
+    CHECK_FALSE(isContentHashedPath("app.js"));
+    CHECK_FALSE(isContentHashedPath("vendor-react.js"));
+    CHECK_FALSE(isContentHashedPath("jquery-3.7.1.min.js"));
+    CHECK_FALSE(isContentHashedPath("app.abcdefgh.js"));
+    CHECK_FALSE(isContentHashedPath("app.1234567.js"));
+    CHECK_FALSE(isContentHashedPath("3f2a9c1b"));
+    CHECK_FALSE(isContentHashedPath(".3f2a9c1b"));
+    CHECK_FALSE(isContentHashedPath("assets.3f2a9c1b/app.js"));
+  }
+}
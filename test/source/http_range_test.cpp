@@ -0,0 +1,96 @@
+#include "catch2/catch_all.hpp"
+#include "utils/http_range.h"
+
+using namespace deskgui::utils;
+
+namespace {
+
+  struct Parsed {
+    RangeStatus status;
+    ByteRange range;
+  };
+
+  Parsed parse(std::string_view header, std::size_t size) {
+    Parsed parsed{RangeStatus::kNone, {}};
+    parsed.status = parseRange(header, size, parsed.range);
+    return parsed;
+  }
+
+}  // namespace
+
+TEST_CASE("parseRange reads single byte ranges") {
+  SECTION("Closed range") {
+    const auto parsed = parse("bytes=2-5", 10);
+    REQUIRE(parsed.status == RangeStatus::kSatisfiable);
+    CHECK(parsed.range.offset == 2);
+    CHECK(parsed.range.length == 4);
+  }
+
+  SECTION("Open range runs to the end") {
+    const auto parsed = parse("bytes=4-", 10);
+    REQUIRE(parsed.status == RangeStatus::kSatisfiable);
+    CHECK(parsed.range.offset == 4);
+    CHECK(parsed.range.length == 6);
+  }
+
+  SECTION("Last byte past the end is clamped") {
+    const auto parsed = parse("bytes=8-1000", 10);
+    REQUIRE(parsed.status == RangeStatus::kSatisfiable);
+    CHECK(parsed.range.offset == 8);
+    CHECK(parsed.range.length == 2);
+  }
+
+  SECTION("Suffix range takes the last bytes") {
+    const auto parsed = parse("bytes=-3", 10);
+    REQUIRE(parsed.status == RangeStatus::kSatisfiable);
+    CHECK(parsed.range.offset == 7);
+    CHECK(parsed.range.length == 3);
+  }
+
+  SECTION("Suffix longer than the content takes all of it") {
+    const auto parsed = parse("bytes=-30", 10);
+    REQUIRE(parsed.status == RangeStatus::kSatisfiable);
+    CHECK(parsed.range.offset == 0);
+    CHECK(parsed.range.length == 10);
+  }
+
+  SECTION("Surrounding whitespace is ignored") {
+    const auto parsed = parse(" bytes= 1 - 1 ", 10);
+    REQUIRE(parsed.status == RangeStatus::kSatisfiable);
+    CHECK(parsed.range.offset == 1);
+    CHECK(parsed.range.length == 1);
+  }
+}
+
+TEST_CASE("parseRange rejects ranges outside of the content") {
+  CHECK(parse("bytes=10-", 10).status == RangeStatus::kUnsatisfiable);
+  CHECK(parse("bytes=10-20", 10).status == RangeStatus::kUnsatisfiable);
+  CHECK(parse("bytes=-0", 10).status == RangeStatus::kUnsatisfiable);
+  CHECK(parse("bytes=0-", 0).status == RangeStatus::kUnsatisfiable);
+  CHECK(parse("bytes=-5", 0).status == RangeStatus::kUnsatisfiable);
+}
+
+TEST_CASE("parseRange ignores the ranges it does not serve") {
+  SECTION("Multiple ranges") {
+    CHECK(parse("bytes=0-1,4-5", 10).status == RangeStatus::kNone);
+    CHECK(parse("bytes=0-1, -2", 10).status == RangeStatus::kNone);
+  }
+
+  SECTION("Invalid values") {
+    CHECK(parse("", 10).status == RangeStatus::kNone);
+    CHECK(parse("items=0-1", 10).status == RangeStatus::kNone);
+    CHECK(parse("bytes=", 10).status == RangeStatus::kNone);
+    CHECK(parse("bytes=5", 10).status == RangeStatus::kNone);
+    CHECK(parse("bytes=-", 10).status == RangeStatus::kNone);
+    CHECK(parse("bytes=5-2", 10).status == RangeStatus::kNone);
+    CHECK(parse("bytes=a-b", 10).status == RangeStatus::kNone);
+    CHECK(parse("bytes=-1-2", 10).status == RangeStatus::kNone);
+    CHECK(parse("bytes=99999999999999999999999-", 10).status == RangeStatus::kNone);
+  }
+}
+
+TEST_CASE("Content-Range values describe the served bytes") {
+  CHECK(contentRange({2, 4}, 10) == "bytes 2-5/10");
+  CHECK(contentRange({0, 10}, 10) == "bytes 0-9/10");
+  CHECK(unsatisfiedRange(10) == "bytes */10");
+}
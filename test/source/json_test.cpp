@@ -0,0 +1,96 @@
+#include <deskgui/json.h>
+
+#include "catch2/catch_all.hpp"
+
+using namespace deskgui;
+
+namespace {
+
+  struct Point {
+    int x = 0;
+    int y = 0;
+  };
+  DESKGUI_REFLECT(Point, x, y)
+
+  struct Shape {
+    std::string name;
+    std::vector<Point> points;
+    std::optional<double> opacity;
+  };
+  DESKGUI_REFLECT(Shape, name, points, opacity)
+
+}  // namespace
+
+TEST_CASE("JSON deserialization into reflected types") {
+  SECTION("Nested structs, vectors and optionals") {
+    Shape shape;
+    REQUIRE(json::parse(
+        R"({"name":"line","unknown":{"a":[1,2]},"points":[{"x":1,"y":2},{"x":3}],"opacity":null})",
+        shape));
+    CHECK(shape.name == "line");
+    REQUIRE(shape.points.size() == 2);
+    CHECK(shape.points[0].y == 2);
+    CHECK(shape.points[1].x == 3);
+    CHECK(shape.points[1].y == 0);
+    CHECK_FALSE(shape.opacity.has_value());
+  }
+
+  SECTION("Type mismatches are rejected") {
+    Point point;
+    CHECK_FALSE(json::parse(R"({"x":"1"})", point));
+    unsigned char small = 0;
+    CHECK_FALSE(json::parse("300", small));
+    CHECK_FALSE(json::parse("{invalid", point));
+  }
+
+  SECTION("Input after the value is rejected") {
+    Point point;
+    CHECK(json::parse("{\"x\":1} \n", point));
+    CHECK_FALSE(json::parse("{\"x\":1} garbage", point));
+    CHECK_FALSE(json::parse("{\"x\":1}{\"y\":2}", point));
+    CHECK_FALSE(json::parse("[1] 2", [](json::TokenReader& reader) {
+      json::Token token;
+      return reader.next(token);
+    }));
+  }
+
+  SECTION("Raw values are captured as compact JSON") {
+    std::map<std::string, json::RawJson> values;
+    REQUIRE(json::parse(R"({"a": [1, 2.5, "x"], "b": {"c": true}})", values));
+    CHECK(values["a"].text == R"([1,2.5,"x"])");
+    CHECK(values["b"].text == R"({"c":true})");
+  }
+}
+
+TEST_CASE("JSON callback bindings") {
+  Point received;
+  std::string label;
+  auto binding = json::bind<Point, std::string>([&](const Point& point, const std::string& text) {
+    received = point;
+    label = text;
+  });
+
+  const auto invoke = [&binding](std::string_view arguments) {
+    return json::parse(arguments, [&binding](json::TokenReader& reader) {
+      json::Token token;
+      if (!reader.next(token)) return false;
+      auto invocation = binding(reader, token);
+      if (!invocation) return false;
+      invocation();
+      return true;
+    });
+  };
+
+  CHECK(invoke(R"([{"x":4,"y":5},"cursor"])"));
+  CHECK(received.x == 4);
+  CHECK(received.y == 5);
+  CHECK(label == "cursor");
+
+  // Missing trailing arguments keep their defaults, extra arguments are ignored.
+  CHECK(invoke(R"([{"x":1}])"));
+  CHECK(label.empty());
+  CHECK(invoke(R"([{"x":1},"a",3,[4]])"));
+  CHECK(label == "a");
+
+  CHECK_FALSE(invoke(R"(["not a point"])"));
+}
@@ -0,0 +1,80 @@
+#include <string>
+
+#include "catch2/catch_all.hpp"
+#include "utils/lru_cache.h"
+
+using namespace deskgui::utils;
+
+TEST_CASE("LruCache evicts the least recently used entries") {
+  LruCache<std::string, int> cache(3);
+  cache.put("a", 1, 1);
+  cache.put("b", 2, 1);
+  cache.put("c", 3, 1);
+
+  SECTION("Oldest entry goes first") {
+    cache.put("d", 4, 1);
+    CHECK_FALSE(cache.get("a").has_value());
+    CHECK(cache.get("b") == 2);
+    CHECK(cache.get("c") == 3);
+    CHECK(cache.get("d") == 4);
+  }
+
+  SECTION("Reading an entry makes it the most recent one") {
+    CHECK(cache.get("a") == 1);
+    cache.put("d", 4, 1);
+    CHECK(cache.get("a") == 1);
+    CHECK_FALSE(cache.get("b").has_value());
+  }
+
+  SECTION("Costly entries evict as many entries as needed") {
+    cache.put("d", 4, 2);
+    CHECK_FALSE(cache.get("a").has_value());
+    CHECK_FALSE(cache.get("b").has_value());
+    CHECK(cache.get("c") == 3);
+    CHECK(cache.get("d") == 4);
+  }
+}
+
+TEST_CASE("LruCache accounts for the cost of its entries") {
+  LruCache<std::string, std::string> cache(10);
+
+  SECTION("Puts add their cost") {
+    cache.put("a", "aaaa", 4);
+    cache.put("b", "bb", 2);
+    CHECK(cache.size() == 6);
+  }
+
+  SECTION("Replacing an entry replaces its cost") {
+    cache.put("a", "aaaa", 4);
+    cache.put("a", "aaaaaaa", 7);
+    CHECK(cache.size() == 7);
+    CHECK(cache.get("a") == std::string{"aaaaaaa"});
+  }
+
+  SECTION("Erase and clear give the cost back") {
+    cache.put("a", "aaaa", 4);
+    cache.put("b", "bb", 2);
+    cache.erase("a");
+    CHECK(cache.size() == 2);
+    cache.erase("missing");
+    CHECK(cache.size() == 2);
+    cache.clear();
+    CHECK(cache.size() == 0);
+    CHECK_FALSE(cache.get("b").has_value());
+  }
+
+  SECTION("Entries costing more than the capacity are not stored") {
+    cache.put("a", "aaaa", 4);
+    cache.put("huge", "h", 11);
+    CHECK_FALSE(cache.get("huge").has_value());
+    CHECK(cache.get("a") == std::string{"aaaa"});
+    CHECK(cache.size() == 4);
+  }
+
+  SECTION("Oversized replacement drops the previous entry") {
+    cache.put("a", "aaaa", 4);
+    cache.put("a", "huge", 11);
+    CHECK_FALSE(cache.get("a").has_value());
+    CHECK(cache.size() == 0);
+  }
+}
@@ -0,0 +1,66 @@
+#include <fstream>
+#include <map>
+#include <regex>
+#include <sstream>
+#include <string>
+
+#include "catch2/catch_all.hpp"
+#include "utils/mime_types.h"
+
+using namespace deskgui::utils;
+
+namespace {
+
+  // MIME_TYPE_MAP of the resource compiler, where later keys override earlier ones.
+  std::map<std::string, std::string> compilerMimeTypes() {
+    std::ifstream file(DESKGUI_MIME_TYPES_PY);
+    std::stringstream content;
+    content << file.rdbuf();
+    const auto text = content.str();
+
+    std::map<std::string, std::string> types;
+    const std::regex entry(R"re("(\.[^"]+)"\s*:\s*"([^"]+)")re");
+    for (std::sregex_iterator it(text.begin(), text.end(), entry), end; it != end; ++it) {
+      types.insert_or_assign((*it)[1].str(), (*it)[2].str());
+    }
+    return types;
+  }
+
+}  // namespace
+
+TEST_CASE("mimeType agrees with the resource compiler") {
+  const auto types = compilerMimeTypes();
+  REQUIRE_FALSE(types.empty());
+
+  SECTION("Same extensions") {
+    CHECK(types.size() == detail::kMimeTypes.size());
+    for (const auto& [extension, mime] : detail::kMimeTypes) {
+      CHECK(types.count(std::string(extension)) == 1);
+    }
+  }
+
+  SECTION("Same types") {
+    for (const auto& [extension, mime] : types) {
+      CHECK(mimeType(extension) == mime);
+    }
+  }
+}
+
+TEST_CASE("mimeType looks up extensions") {
+  SECTION("Table is sorted for the binary search") {
+    for (std::size_t i = 1; i < detail::kMimeTypes.size(); ++i) {
+      CHECK(detail::kMimeTypes[i - 1].first < detail::kMimeTypes[i].first);
+    }
+  }
+
+  SECTION("Case insensitive") {
+    CHECK(mimeType(".HTML") == "text/html");
+    CHECK(mimeType(".Js") == "application/javascript");
+  }
+
+  SECTION("Unknown extensions") {
+    CHECK(mimeType(".unknown") == "application/octet-stream");
+    CHECK(mimeType("") == "application/octet-stream");
+    CHECK(mimeType("html") == "application/octet-stream");
+  }
+}
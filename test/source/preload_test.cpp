@@ -0,0 +1,71 @@
+#include <string>
+
+#include "catch2/catch_all.hpp"
+#include "utils/preload.h"
+
+using namespace deskgui::utils;
+
+TEST_CASE("isHtml recognizes the MIME type of pages") {
+  CHECK(isHtml("text/html"));
+  CHECK(isHtml("text/html; charset=utf-8"));
+  CHECK_FALSE(isHtml("text/htmlx"));
+  CHECK_FALSE(isHtml("application/xhtml+xml"));
+  CHECK_FALSE(isHtml("text/plain"));
+  CHECK_FALSE(isHtml(""));
+}
+
+TEST_CASE("preloadLink requests resources as the page will") {
+  SECTION("Destinations") {
+    CHECK(preloadLink("app.css", "text/css")
+          == "<link rel=\"preload\" href=\"app.css\" as=\"style\">");
+    CHECK(preloadLink("app.js", "application/javascript")
+          == "<link rel=\"preload\" href=\"app.js\" as=\"script\">");
+    CHECK(preloadLink("logo.png", "image/png")
+          == "<link rel=\"preload\" href=\"logo.png\" as=\"image\">");
+  }
+
+  SECTION("Fonts and fetched data are requested in CORS mode") {
+    CHECK(preloadLink("inter.woff2", "font/woff2")
+          == "<link rel=\"preload\" href=\"inter.woff2\" as=\"font\" crossorigin>");
+    CHECK(preloadLink("old.woff", "application/font-woff")
+          == "<link rel=\"preload\" href=\"old.woff\" as=\"font\" crossorigin>");
+    CHECK(preloadLink("data.json", "application/json")
+          == "<link rel=\"preload\" href=\"data.json\" as=\"fetch\" crossorigin>");
+  }
+
+  SECTION("URLs are escaped") {
+    CHECK(preloadLink("a\"b&c<d.css", "text/css")
+          == "<link rel=\"preload\" href=\"a&quot;b&amp;c&lt;d.css\" as=\"style\">");
+  }
+}
+
+TEST_CASE("insertIntoHead places markup at the start of the head") {
+  const std::string markup = "<link>";
+
+  SECTION("After the head tag") {
+    CHECK(insertIntoHead("<html><head><title>t</title></head></html>", markup)
+          == "<html><head><link><title>t</title></head></html>");
+    CHECK(insertIntoHead("<HTML><HEAD lang=\"en\">x", markup)
+          == "<HTML><HEAD lang=\"en\"><link>x");
+    CHECK(insertIntoHead("<head/>", markup) == "<head/><link>");
+  }
+
+  SECTION("After the html tag without head") {
+    CHECK(insertIntoHead("<!DOCTYPE html><html lang=\"en\"><body><header>h</header></body>",
+                         markup)
+          == "<!DOCTYPE html><html lang=\"en\"><link><body><header>h</header></body>");
+  }
+
+  SECTION("At the start of a fragment") {
+    CHECK(insertIntoHead("<p>text</p>", markup) == "<link><p>text</p>");
+    CHECK(insertIntoHead("", markup) == "<link>");
+    CHECK(insertIntoHead("<head", markup) == "<link><head");
+  }
+}
+
+TEST_CASE("stableHash is the 64-bit FNV-1a hash") {
+  CHECK(stableHash("") == 0xcbf29ce484222325ull);
+  CHECK(stableHash("a") == 0xaf63dc4c8601ec8cull);
+  CHECK(stableHash("foobar") == 0x85944171f73967e8ull);
+  CHECK(stableHash("page") != stableHash("Page"));
+}
@@ -0,0 +1,86 @@
+#include <deskgui/resource_archive.h>
+
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <string>
+
+#include "catch2/catch_all.hpp"
+
+using namespace deskgui;
+
+namespace {
+
+  template <typename T> void put(std::string& bytes, T value) {
+    bytes.append(reinterpret_cast<const char*>(&value), sizeof(T));
+  }
+
+  // Single entry archive serving "index.html", in the layout of resource_archive.py.
+  std::string makeArchive(const std::string& html) {
+    const std::string strings = "index.htmltext/htmlcafe";
+    const std::uint64_t stringsOffset = 32 + 48;
+    const std::uint64_t dataOffset = (stringsOffset + strings.size() + 15) / 16 * 16;
+
+    std::string bytes = "DSKGUIRA";
+    put<std::uint32_t>(bytes, 2);
+    put<std::uint32_t>(bytes, 1);
+    put<std::uint64_t>(bytes, 32);
+    put<std::uint64_t>(bytes, stringsOffset);
+    put<std::uint64_t>(bytes, dataOffset);
+    put<std::uint64_t>(bytes, html.size());
+    for (std::uint32_t field : {0u, 10u, 10u, 9u, 19u, 0u, 19u, 4u}) put(bytes, field);
+    bytes += strings;
+    bytes.resize(dataOffset, '\0');
+    return bytes + html;
+  }
+
+  std::string writeFile(const std::string& name, const std::string& bytes) {
+    const auto path = (std::filesystem::temp_directory_path() / name).string();
+    std::ofstream(path, std::ios::binary) << bytes;
+    return path;
+  }
+
+}  // namespace
+
+TEST_CASE("Resource archives") {
+  const std::string html = "<html><body>archived</body></html>";
+
+  SECTION("Entries refer to the mapped file") {
+    const auto path = writeFile("deskgui_archive_test.pak", makeArchive(html));
+    const auto resources = loadResourceArchive(path);
+    REQUIRE(resources.size() == 1);
+    CHECK(resources[0].scheme == "index.html");
+    CHECK(resources[0].mime == "text/html");
+    CHECK(resources[0].encoding.empty());
+    CHECK(resources[0].hash == "cafe");
+    CHECK(std::string(resources[0].content.begin(), resources[0].content.end()) == html);
+    CHECK(reinterpret_cast<std::uintptr_t>(resources[0].content.data()) % 16 == 0);
+    CHECK_FALSE(resources[0].content.isStatic());
+    std::remove(path.c_str());
+  }
+
+  SECTION("Archives appended to another file") {
+    const auto archive = makeArchive(html);
+    std::string bytes(4096, 'x');
+    bytes += archive;
+    put<std::uint64_t>(bytes, archive.size());
+    bytes += "DSKGUIRA";
+
+    const auto path = writeFile("deskgui_appended_test.bin", bytes);
+    const auto resources = loadResourceArchive(path);
+    REQUIRE(resources.size() == 1);
+    CHECK(std::string(resources[0].content.begin(), resources[0].content.end()) == html);
+    std::remove(path.c_str());
+  }
+
+  SECTION("Invalid archives are rejected") {
+    auto truncated = makeArchive(html);
+    truncated.resize(truncated.size() - 4);
+    const auto path = writeFile("deskgui_truncated_test.pak", truncated);
+    CHECK_THROWS_AS(loadResourceArchive(path), std::runtime_error);
+    std::remove(path.c_str());
+
+    CHECK_THROWS_AS(loadResourceArchive("missing_archive.pak"), std::runtime_error);
+  }
+}
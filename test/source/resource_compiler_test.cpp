@@ -0,0 +1,48 @@
+#include <deskgui/resource_compiler.h>
+
+#include <cstdint>
+#include <string>
+
+#include "catch2/catch_all.hpp"
+
+using namespace deskgui;
+
+namespace {
+
+  std::string content(const ResourceRegistry& registry, std::string_view path) {
+    const auto* resource = registry.find(path);
+    if (!resource) return {};
+    return {reinterpret_cast<const char*>(resource->data), resource->size};
+  }
+
+}  // namespace
+
+TEST_CASE("Resource compiler packs files sharing their name") {
+  const auto registry = getCompiledResourceRegistry("test_resources");
+  REQUIRE(registry.size() == 4);
+
+  CHECK(content(registry, "app.css") == "p { margin: 0; }\n");
+  CHECK(content(registry, "app.js") == "document.title = 'app';\n");
+  CHECK(content(registry, "css/app.css") == "body { color: red; }\n");
+  CHECK(content(registry, "js/app.js") == "console.log('js/app.js');\n");
+  CHECK(registry.find("css/app.css")->mime == "text/css");
+  CHECK(registry.find("js/app.js")->mime == "application/javascript");
+}
+
+TEST_CASE("ResourceRegistry finds entries by path") {
+  static const std::uint8_t bytes[] = {'a', 'b'};
+  static const ResourceEntry app{"app.js", bytes, 2, "text/javascript", ""};
+  static const ResourceEntry index{"index.html", bytes, 1, "text/html", ""};
+  static const ResourceEntry* const entries[] = {&app, &index};
+  const ResourceRegistry registry(entries, 2);
+
+  REQUIRE(registry.find("index.html") == &index);
+  CHECK(registry.find("app.js") == &app);
+  CHECK(registry.find("missing.html") == nullptr);
+  CHECK(ResourceRegistry().find("index.html") == nullptr);
+
+  const auto resources = registry.resources();
+  REQUIRE(resources.size() == 2);
+  CHECK(resources[1].scheme == "index.html");
+  CHECK(resources[1].content.data() == bytes);
+}
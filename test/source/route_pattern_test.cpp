@@ -0,0 +1,59 @@
+#include "catch2/catch_all.hpp"
+#include "utils/route_pattern.h"
+
+using namespace deskgui::utils;
+
+TEST_CASE("matchRoute matches paths with route patterns") {
+  std::map<std::string, std::string> params;
+
+  SECTION("Literal segments") {
+    CHECK(matchRoute("api/health", "api/health", params));
+    CHECK(params.empty());
+    CHECK_FALSE(matchRoute("api/health", "api/healthz", params));
+    CHECK_FALSE(matchRoute("api/health", "api", params));
+    CHECK_FALSE(matchRoute("api/health", "api/health/more", params));
+    CHECK_FALSE(matchRoute("api", "", params));
+  }
+
+  SECTION("Named segments") {
+    REQUIRE(matchRoute("api/users/:id", "api/users/42", params));
+    CHECK(params == std::map<std::string, std::string>{{"id", "42"}});
+
+    REQUIRE(matchRoute("api/:kind/:id/posts", "api/users/7/posts", params));
+    CHECK(params == std::map<std::string, std::string>{{"kind", "users"}, {"id", "7"}});
+  }
+
+  SECTION("Named segments are not empty") {
+    CHECK_FALSE(matchRoute("api/users/:id", "api/users/", params));
+    CHECK_FALSE(matchRoute("api/users/:id", "api/users", params));
+    CHECK_FALSE(matchRoute("api/:kind/list", "api//list", params));
+  }
+
+  SECTION("Wildcard captures the rest of the path") {
+    REQUIRE(matchRoute("files/*", "files/docs/a.txt", params));
+    CHECK(params["*"] == "docs/a.txt");
+
+    REQUIRE(matchRoute("files/*", "files", params));
+    CHECK(params["*"].empty());
+
+    REQUIRE(matchRoute("*", "any/path", params));
+    CHECK(params["*"] == "any/path");
+  }
+
+  SECTION("Captures are percent-decoded") {
+    REQUIRE(matchRoute("users/:name/*", "users/Ada%20L/a%2Fb", params));
+    CHECK(params["name"] == "Ada L");
+    CHECK(params["*"] == "a/b");
+  }
+
+  SECTION("Malformed escapes are kept as they are") {
+    REQUIRE(matchRoute("users/:name", "users/100%", params));
+    CHECK(params["name"] == "100%");
+  }
+
+  SECTION("Params are left alone when the path does not match") {
+    params["kept"] = "yes";
+    CHECK_FALSE(matchRoute("api/users/:id/posts", "api/users/42", params));
+    CHECK(params == std::map<std::string, std::string>{{"kept", "yes"}});
+  }
+}
@@ -0,0 +1,58 @@
+#include "catch2/catch_all.hpp"
+#include "utils/url.h"
+
+using namespace deskgui::utils;
+
+TEST_CASE("percentDecode decodes URL paths") {
+  SECTION("Escapes") {
+    CHECK(percentDecode("a%20b") == std::string{"a b"});
+    CHECK(percentDecode("%E2%82%AC") == std::string{"\xE2\x82\xAC"});
+    CHECK(percentDecode("%2e%2E") == std::string{".."});
+    CHECK(percentDecode("..%2f") == std::string{"../"});
+    CHECK(percentDecode("plain/path.html") == std::string{"plain/path.html"});
+    CHECK(percentDecode("") == std::string{});
+  }
+
+  SECTION("Malformed escapes") {
+    CHECK_FALSE(percentDecode("%").has_value());
+    CHECK_FALSE(percentDecode("a%2").has_value());
+    CHECK_FALSE(percentDecode("%zz").has_value());
+    CHECK_FALSE(percentDecode("%2g").has_value());
+  }
+
+  SECTION("Encoded NUL") {
+    CHECK_FALSE(percentDecode("%00").has_value());
+    CHECK_FALSE(percentDecode("index.html%00.png").has_value());
+  }
+}
+
+TEST_CASE("isContainedPath keeps paths inside their directory") {
+  SECTION("Relative paths") {
+    CHECK(isContainedPath("index.html"));
+    CHECK(isContainedPath("assets/app.js"));
+    CHECK(isContainedPath("a/./b"));
+    CHECK(isContainedPath("..a/b..c/..."));
+    CHECK(isContainedPath(""));
+  }
+
+  SECTION("Parent segments") {
+    CHECK_FALSE(isContainedPath(".."));
+    CHECK_FALSE(isContainedPath("../secret"));
+    CHECK_FALSE(isContainedPath("a/../../secret"));
+    CHECK_FALSE(isContainedPath("a/.."));
+  }
+
+  SECTION("Decoded traversals") {
+    CHECK_FALSE(isContainedPath(*percentDecode("%2e%2e/secret")));
+    CHECK_FALSE(isContainedPath(*percentDecode("a/..%2f..%2fsecret")));
+    CHECK_FALSE(isContainedPath(*percentDecode("..%5csecret")));
+  }
+
+  SECTION("Absolute paths") {
+    CHECK_FALSE(isContainedPath("/etc/passwd"));
+    CHECK_FALSE(isContainedPath("C:/Windows"));
+    CHECK_FALSE(isContainedPath("C:secret"));
+    CHECK_FALSE(isContainedPath("\\\\server\\share"));
+    CHECK_FALSE(isContainedPath("a\\..\\..\\secret"));
+  }
+}
@@ -3,6 +3,15 @@
 
 #include <deskgui/app.h>
 
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <future>
+#include <stdexcept>
+#include <thread>
+
 #include "catch2/catch_all.hpp"
 
 using namespace deskgui;
@@ -62,6 +71,32 @@ namespace {
     return capturedUrl;
   }
 
+  // Runs the app until the page loaded by `load` has finished loading, and returns the JSON
+  // result of `script` evaluated then, empty when the evaluation failed.
+  std::string evaluateLoaded(App& app, Webview* webview, const std::string& script,
+                             const std::function<void()>& load) {
+    std::string json;
+    const auto listener = webview->connect<event::WebviewContentLoaded>([&]() {
+      webview->evaluate(script, [&app, &json](bool success, std::string_view result) {
+        if (success) json = result;
+        app.terminate();
+      });
+    });
+    load();
+    app.run();
+    webview->disconnect<event::WebviewContentLoaded>(listener);
+    return json;
+  }
+
+  // Serves a page and returns the text of its body once loaded.
+  std::string bodyText(App& app, Webview* webview, const std::string& resource) {
+    std::string body;
+    json::parse(evaluateLoaded(app, webview, "document.body.textContent",
+                               [webview, &resource]() { webview->serveResource(resource); }),
+                body);
+    return body;
+  }
+
 }  // namespace
 
 TEST_CASE("Webview serveResource uses the configured scheme origin") {
@@ -100,3 +135,459 @@ TEST_CASE("Webview serveResource uses the configured scheme origin") {
     CHECK(url == "webview://localhost/index.html");
   }
 }
+
+TEST_CASE("Webview outgoing queue applies its policy") {
+  SECTION("Drop oldest keeps the newest messages") {
+    WebviewOptions options;
+    options.setOption(WebviewOptions::kOutgoingQueueCapacity, 2);
+
+    App app("WebviewQueueTestDropOldest");
+    auto window = app.createWindow("window");
+    auto webview = window->createWebview("Webview", options);
+
+    for (int i = 0; i < 5; ++i) {
+      webview->postMessage(std::to_string(i));
+    }
+    CHECK(webview->outgoingQueueStats().queued == 2);
+    CHECK(webview->outgoingQueueStats().dropped == 3);
+  }
+
+  SECTION("Coalesce replaces messages with the same key") {
+    WebviewOptions options;
+    options.setOption(WebviewOptions::kOutgoingQueueCapacity, 4);
+    options.setOption(WebviewOptions::kOutgoingQueuePolicy, std::string{"coalesce"});
+
+    App app("WebviewQueueTestCoalesce");
+    auto window = app.createWindow("window");
+    auto webview = window->createWebview("Webview", options);
+
+    for (int i = 0; i < 5; ++i) {
+      webview->postMessage(std::to_string(i), "progress");
+    }
+    CHECK(webview->outgoingQueueStats().queued == 1);
+    CHECK(webview->outgoingQueueStats().dropped == 4);
+  }
+
+  SECTION("Unknown policies fail the webview creation") {
+    WebviewOptions options;
+    options.setOption(WebviewOptions::kOutgoingQueueCapacity, 2);
+    options.setOption(WebviewOptions::kOutgoingQueuePolicy, std::string{"fifo"});
+
+    App app("WebviewQueueTestInvalid");
+    auto window = app.createWindow("window");
+    CHECK(window->createWebview("Webview", options) == nullptr);
+  }
+}
+
+TEST_CASE("Webview rejects page messages past the capacity of the block policy") {
+  WebviewOptions options;
+  options.setOption(WebviewOptions::kIncomingQueueCapacity, 1);
+  options.setOption(WebviewOptions::kIncomingQueuePolicy, std::string{"block"});
+
+  App app("WebviewIncomingBlockTest");
+  auto window = app.createWindow("window");
+  auto webview = window->createWebview("Webview", options);
+
+  std::string statuses;
+  webview->addCallback<std::string>("report", [&app, &statuses](const std::string& reported) {
+    statuses = reported;
+    app.terminate();
+  });
+  // One message in flight, one waiting for credit, the third one finds the page queue full.
+  webview->connect<event::WebviewContentLoaded>([webview]() {
+    webview->executeScript(
+        "Promise.allSettled([0, 1, 2].map((i) => window.webview.postMessage({ key: 'count', "
+        "payload: i }))).then((results) => window.report(results.map((r) => r.status).join()));");
+  });
+  webview->loadHTMLString("<html><body></body></html>");
+  app.run();
+
+  CHECK(statuses == "fulfilled,fulfilled,rejected");
+}
+
+TEST_CASE("Webview runs the queued messages of a replaced worker callback") {
+  WebviewOptions options;
+  options.setOption(WebviewOptions::kMessageWorkerThreads, 2);
+
+  App app("WebviewWorkerReplaceTest");
+  auto window = app.createWindow("window");
+  auto webview = window->createWebview("Webview", options);
+
+  std::promise<void> release;
+  auto released = release.get_future().share();
+  std::atomic<int> calls{0};
+  webview->addCallback(
+      "work",
+      [released, &calls](std::string_view) {
+        released.wait();
+        ++calls;
+      },
+      CallbackThread::kWorker);
+
+  int messages = 0;
+  webview->connect<event::WebviewOnMessage>([&]() {
+    // The first message holds the worker, the next ones wait on the queue of the callback.
+    if (++messages == 1) {
+      webview->addCallback(
+          "work", [&calls](std::string_view) { ++calls; }, CallbackThread::kWorker);
+      release.set_value();
+    }
+    if (messages == 5) app.terminate();
+  });
+  webview->connect<event::WebviewContentLoaded>([webview]() {
+    webview->executeScript("for (let i = 0; i < 5; ++i) window.work(i);");
+  });
+  webview->loadHTMLString("<html><body></body></html>");
+  app.run();
+
+  const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+  while (webview->incomingQueueStats().queued > 0 && std::chrono::steady_clock::now() < deadline) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  CHECK(calls == 5);
+  CHECK(webview->incomingQueueStats().queued == 0);
+}
+
+TEST_CASE("Webview evaluate returns the script result as JSON") {
+  App app("WebviewEvaluateTest");
+  auto window = app.createWindow("window");
+  auto webview = window->createWebview("Webview");
+
+  const auto result = evaluateLoaded(app, webview, "({ sum: 1 + 2 }).sum", [webview]() {
+    webview->loadHTMLString("<html><body></body></html>");
+  });
+  int sum = 0;
+  CHECK(json::parse(result, sum));
+  CHECK(sum == 3);
+}
+
+TEST_CASE("Webview serves loaded resources by path") {
+  App app("WebviewResourceLookupTest");
+  auto window = app.createWindow("window");
+  auto webview = window->createWebview("Webview");
+
+  const std::string html = "<html><body>served</body></html>";
+  Resources resources;
+  resources.push_back({"other.html", {}, "text/html"});
+  resources.push_back({"index.html", {html.begin(), html.end()}, "text/html"});
+  webview->loadResources(std::move(resources));
+  CHECK(bodyText(app, webview, "index.html?version=1") == "served");
+}
+
+TEST_CASE("ResourcePack is shared by webviews") {
+  static const std::uint8_t bytes[] = {'a', 'b'};
+  static const ResourceEntry script{"app.js", bytes, 2, "text/javascript", ""};
+  static const ResourceEntry* const entries[] = {&script};
+  const auto compiled = std::make_shared<const ResourcePack>(ResourceRegistry(entries, 1));
+  REQUIRE(compiled->find("app.js") != nullptr);
+  CHECK(compiled->find("app.js") == compiled->find("app.js"));
+  CHECK(compiled->find("app.js")->content.data() == bytes);
+  CHECK(compiled->find("index.html") == nullptr);
+
+  Resources resources;
+  resources.push_back({"index.html", {'<', 'p', '>'}, "text/html"});
+  const auto pack = std::make_shared<const ResourcePack>(std::move(resources));
+  REQUIRE(pack->size() == 1);
+  const auto* index = pack->find("index.html");
+  REQUIRE(index != nullptr);
+
+  App app("WebviewResourcePackTest");
+  auto window = app.createWindow("window");
+  auto first = window->createWebview("First");
+  auto second = window->createWebview("Second");
+  first->loadResources(pack);
+  second->loadResources(first->resourcePack());
+  CHECK(second->resourcePack() == pack);
+  CHECK(pack->find("index.html") == index);
+
+  first->loadResources(compiled);
+  CHECK(first->resourcePack() == compiled);
+  CHECK(second->resourcePack() == pack);
+  second->clearResources();
+  CHECK(second->resourcePack() == nullptr);
+}
+
+TEST_CASE("Webview serves registry resources on request") {
+  App app("WebviewResourceRegistryTest");
+  auto window = app.createWindow("window");
+  auto webview = window->createWebview("Webview");
+
+  static const std::string html = "<html><body>resolved</body></html>";
+  static const ResourceEntry index{"index.html", reinterpret_cast<const std::uint8_t*>(html.data()),
+                                   html.size(), "text/html", ""};
+  static const ResourceEntry* const entries[] = {&index};
+  webview->loadResources(ResourceRegistry(entries, 1));
+  CHECK(bodyText(app, webview, "index.html") == "resolved");
+}
+
+TEST_CASE("Webview serves files of a mounted directory") {
+  const auto directory = std::filesystem::temp_directory_path() / "deskgui_serve_directory_test";
+  std::filesystem::create_directories(directory / "pages");
+  std::ofstream(directory / "pages" / "index.html") << "<html><body>from disk</body></html>";
+
+  App app("WebviewServeDirectoryTest");
+  auto window = app.createWindow("window");
+  auto webview = window->createWebview("Webview");
+
+  CHECK_THROWS_AS(webview->serveDirectory("missing", (directory / "missing").string()),
+                  std::invalid_argument);
+  webview->serveDirectory("/site", directory.string());
+  CHECK(bodyText(app, webview, "site/pages/") == "from disk");
+
+  std::filesystem::remove_all(directory);
+}
+
+TEST_CASE("Webview streams large files of a mounted directory") {
+  const auto directory = std::filesystem::temp_directory_path() / "deskgui_stream_file_test";
+  std::filesystem::create_directories(directory);
+  std::ofstream(directory / "index.html") << "<html><body></body></html>";
+  const auto letter = [](std::size_t offset) { return static_cast<char>('a' + offset % 26); };
+  {
+    std::ofstream large(directory / "large.txt", std::ios::binary);
+    for (std::size_t i = 0; i < 3 * 1024 * 1024; ++i) large.put(letter(i));
+  }
+
+  App app("WebviewStreamFileTest");
+  auto window = app.createWindow("window");
+  auto webview = window->createWebview("Webview");
+  webview->serveDirectory("", directory.string());
+
+  std::string fetched;
+  webview->addCallback<std::string>("report", [&app, &fetched](const std::string& reported) {
+    fetched = reported;
+    app.terminate();
+  });
+  // Past the cache limit the file is streamed, a range still reads only its slice.
+  webview->connect<event::WebviewContentLoaded>([webview]() {
+    webview->executeScript(
+        "Promise.all([fetch('large.txt').then((r) => r.text()), fetch('large.txt', { headers: { "
+        "Range: 'bytes=2097152-2097155' } }).then((r) => r.text())]).then(([whole, range]) => "
+        "window.report(whole.length + ' ' + range));");
+  });
+  webview->serveResource("index.html");
+  app.run();
+
+  const std::string range{letter(2097152), letter(2097153), letter(2097154), letter(2097155)};
+  CHECK(fetched == "3145728 " + range);
+
+  std::filesystem::remove_all(directory);
+}
+
+TEST_CASE("Webview looks up resource layers from the top") {
+  const auto directory = std::filesystem::temp_directory_path() / "deskgui_resource_layer_test";
+  std::filesystem::create_directories(directory / "served");
+  std::ofstream(directory / "index.html") << "<html><body>override</body></html>";
+  std::ofstream(directory / "served" / "index.html") << "<html><body>served</body></html>";
+
+  App app("WebviewResourceLayerTest");
+  auto window = app.createWindow("window");
+  auto webview = window->createWebview("Webview");
+
+  const auto page = [](const std::string& text) {
+    const std::string html = "<html><body>" + text + "</body></html>";
+    Resources resources;
+    resources.push_back({"index.html", {html.begin(), html.end()}, "text/html"});
+    return std::make_shared<const ResourcePack>(std::move(resources));
+  };
+  webview->serveDirectory("", (directory / "served").string());
+  webview->loadResources(page("base"));
+  webview->mountResources("plugin", page("plugin"));
+  webview->mountDirectory("overrides", directory.string());
+  CHECK_THROWS_AS(webview->mountResources("", page("unnamed")), std::invalid_argument);
+
+  int request = 0;
+  const auto serve = [&]() {
+    return bodyText(app, webview, "index.html?request=" + std::to_string(++request));
+  };
+
+  CHECK(serve() == "override");
+  webview->unmountResources("overrides");
+  CHECK(serve() == "plugin");
+  webview->mountResources("plugin", page("swapped"));
+  CHECK(serve() == "swapped");
+  webview->unmountResources("plugin");
+  CHECK(serve() == "base");
+  CHECK(webview->resourcePack() != nullptr);
+  webview->loadResources(std::shared_ptr<const ResourcePack>());
+  CHECK(serve() == "served");
+
+  std::filesystem::remove_all(directory);
+}
+
+TEST_CASE("Webview answers requests with route handlers") {
+  App app("WebviewRouteTest");
+  auto window = app.createWindow("window");
+  auto webview = window->createWebview("Webview");
+
+  webview->addRoute("pages/:id", [](const RouteRequest& request, RouteResponse response) {
+    response.setHeader("Content-Type", "text/html");
+    response.write("<html><body>page ");
+    response.end(request.params.at("id") + "</body></html>");
+  });
+  CHECK(bodyText(app, webview, "pages/42") == "page 42");
+}
+
+TEST_CASE("Webview counts the requests to its resources") {
+  App app("WebviewResourceStatsTest");
+  auto window = app.createWindow("window");
+  auto webview = window->createWebview("Webview");
+
+  const std::string html
+      = "<html><head><script src=\"missing.js?v=1#top\"></script></head></html>";
+  Resources resources;
+  resources.push_back({"index.html", {html.begin(), html.end()}, "text/html"});
+  webview->loadResources(std::move(resources));
+  CHECK(webview->resourceStats().paths.empty());
+
+  webview->connect<event::WebviewContentLoaded>([&app]() { app.terminate(); });
+  webview->serveResource("index.html");
+  app.run();
+
+  const auto stats = webview->resourceStats();
+  CHECK(stats.hits == 1);
+  CHECK(stats.misses == 1);
+  CHECK(stats.bytes == html.size());
+  REQUIRE(stats.paths.count("index.html") == 1);
+  CHECK(stats.paths.at("index.html").hits == 1);
+  REQUIRE(stats.paths.count("missing.js") == 1);
+  CHECK(stats.paths.at("missing.js").misses == 1);
+  CHECK(stats.paths.size() == 2);
+}
+
+TEST_CASE("Webview counts the requests to too many paths together") {
+  App app("WebviewResourceStatsLimitTest");
+  auto window = app.createWindow("window");
+  auto webview = window->createWebview("Webview");
+
+  const auto requests = ResourceStats::kMaxPaths + 10;
+  const std::string html = "<html><head><script>Promise.all(Array.from({length: "
+                           + std::to_string(requests)
+                           + "}, (_, i) => fetch('generated/' + i + '?i=' + i).catch(() => {})))"
+                             ".then(() => window.done());</script></head></html>";
+  Resources resources;
+  resources.push_back({"index.html", {html.begin(), html.end()}, "text/html"});
+  webview->loadResources(std::move(resources));
+
+  webview->addCallback("done", [&app](std::string_view) { app.terminate(); });
+  webview->serveResource("index.html");
+  app.run();
+
+  const auto stats = webview->resourceStats();
+  CHECK(stats.misses >= requests);
+  CHECK(stats.paths.size() == ResourceStats::kMaxPaths + 1);
+  REQUIRE(stats.paths.count(std::string(ResourceStats::kOtherPaths)) == 1);
+  // index.html takes one of the paths counted apart, and so might a favicon request.
+  CHECK(stats.paths.at(std::string(ResourceStats::kOtherPaths)).misses >= 10);
+}
+
+TEST_CASE("Webview adds the preload links of the pack to its pages") {
+  App app("WebviewPreloadTest");
+  auto window = app.createWindow("window");
+  auto webview = window->createWebview("Webview");
+
+  const std::string html = "<html><head><title>page</title></head><body></body></html>";
+  const std::string css = "body{margin:0}";
+  Resources resources;
+  resources.push_back({"index.html", {html.begin(), html.end()}, "text/html"});
+  resources.push_back({"style.css", {css.begin(), css.end()}, "text/css"});
+  const auto pack = std::make_shared<const ResourcePack>(
+      std::move(resources), std::vector<std::string>{"style.css", "index.html", "missing.js"});
+  CHECK(pack->preload().size() == 3);
+  webview->loadResources(pack);
+
+  const auto result = evaluateLoaded(
+      app, webview,
+      "Array.from(document.head.querySelectorAll('link[rel=preload]'), l => l.as).join()",
+      [webview]() { webview->serveResource("index.html"); });
+  std::string links;
+  CHECK(json::parse(result, links));
+  CHECK(links == "style");
+}
+
+TEST_CASE("Window hands out webviews of the pool of the application") {
+  App app("WebviewPoolTest");
+  auto window = app.createWindow("window");
+
+  Resources resources;
+  resources.push_back({"index.html", {'o', 'k'}, "text/html"});
+  const auto pack = std::make_shared<const ResourcePack>(std::move(resources));
+  app.setWebviewPool(1, {}, pack);
+
+  // The pool fills on the main loop, WebView2 gets its webviews ready asynchronously.
+  std::function<void()> waitForPool = [&app, &waitForPool]() {
+    if (app.pooledWebviewCount() == 1) {
+      app.terminate();
+    } else {
+      app.postOnMainThread([&waitForPool]() { waitForPool(); });
+    }
+  };
+  app.postOnMainThread([&waitForPool]() { waitForPool(); });
+  app.run();
+  REQUIRE(app.pooledWebviewCount() == 1);
+
+  auto webview = window->createWebview("Webview");
+  REQUIRE(webview != nullptr);
+  CHECK(webview->getName() == "Webview");
+  CHECK(webview->isReady());
+  CHECK(webview->resourcePack() == pack);
+  CHECK(app.pooledWebviewCount() == 0);
+
+  WebviewOptions other;
+  other.setOption(WebviewOptions::kAsyncCreation, true);
+  app.postOnMainThread([&waitForPool]() { waitForPool(); });
+  app.run();
+  CHECK(app.pooledWebviewCount() == 1);
+  CHECK(window->createWebview("Other", other) != nullptr);
+  CHECK(app.pooledWebviewCount() == 1);
+}
+
+TEST_CASE("Webviews of a context group serve their own resources") {
+  App app("WebviewContextGroupTest");
+  WebviewOptions options;
+  options.setOption(WebviewOptions::kContextGroup, std::string{"panels"});
+  options.setOption(WebviewOptions::kWebProcessLimit, 1);
+
+  const auto open = [&app, &options](const std::string& name) {
+    auto webview = app.createWindow(name)->createWebview("Webview", options);
+    const std::string html = "<html><body>" + name + "</body></html>";
+    Resources resources;
+    resources.push_back({"index.html", {html.begin(), html.end()}, "text/html"});
+    webview->loadResources(std::move(resources));
+    return webview;
+  };
+  auto first = open("first");
+  auto second = open("second");
+
+  CHECK(bodyText(app, first, "index.html") == "first");
+  CHECK(bodyText(app, second, "index.html") == "second");
+}
+
+TEST_CASE("Webviews of an ephemeral context group share their storage") {
+  App app("WebviewContextGroupStorageTest");
+
+  // Evaluates a script in a page of a new webview of the group, returns its JSON result.
+  const auto evaluateIn = [&app](const std::string& name, const std::string& group,
+                                 const std::string& script, bool ephemeral = true) {
+    WebviewOptions options;
+    options.setOption(WebviewOptions::kEphemeralSession, ephemeral);
+    options.setOption(WebviewOptions::kContextGroup, group);
+    auto webview = app.createWindow(name)->createWebview("Webview", options);
+    const std::string html = "<html><body></body></html>";
+    Resources resources;
+    resources.push_back({"index.html", {html.begin(), html.end()}, "text/html"});
+    webview->loadResources(std::move(resources));
+    return evaluateLoaded(app, webview, script,
+                          [webview]() { webview->serveResource("index.html"); });
+  };
+
+  const std::string read = "localStorage.getItem('value')";
+  CHECK(evaluateIn("writer", "shared", "localStorage.setItem('value', 'shared'); " + read)
+        == "\"shared\"");
+  CHECK(evaluateIn("reader", "shared", read) == "\"shared\"");
+#if !defined(_WIN32)
+  // WebView2 has no context groups, its private webviews share one profile.
+  CHECK(evaluateIn("stranger", "other", read) == "null");
+#endif
+  // A persistent webview of the same name is in another group, ephemeral data stays in memory.
+  CHECK(evaluateIn("persistent", "shared", read, false) == "null");
+}
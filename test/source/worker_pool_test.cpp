@@ -0,0 +1,68 @@
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "catch2/catch_all.hpp"
+#include "utils/worker_pool.h"
+
+using namespace deskgui::utils;
+
+namespace {
+
+  template <typename Predicate> bool waitFor(Predicate predicate) {
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (!predicate()) {
+      if (std::chrono::steady_clock::now() > deadline) return false;
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    return true;
+  }
+
+}  // namespace
+
+TEST_CASE("SerialQueue runs its tasks in posting order") {
+  WorkerPool pool(4);
+  auto queue = std::make_shared<SerialQueue>(pool);
+
+  std::mutex mutex;
+  std::vector<int> order;
+  for (int i = 0; i < 100; ++i) {
+    queue->post([&mutex, &order, i] {
+      std::lock_guard<std::mutex> lock(mutex);
+      order.push_back(i);
+    });
+  }
+
+  REQUIRE(waitFor([&] {
+    std::lock_guard<std::mutex> lock(mutex);
+    return order.size() == 100;
+  }));
+  for (int i = 0; i < 100; ++i) {
+    CHECK(order[i] == i);
+  }
+}
+
+TEST_CASE("SerialQueue runs the queued tasks after its owner drops it") {
+  WorkerPool pool(2);
+  auto queue = std::make_shared<SerialQueue>(pool);
+
+  std::promise<void> release;
+  auto released = release.get_future().share();
+  std::atomic<int> ran{0};
+  queue->post([released, &ran] {
+    released.wait();
+    ++ran;
+  });
+  for (int i = 0; i < 40; ++i) {
+    queue->post([&ran] { ++ran; });
+  }
+
+  // Same as replacing a worker callback while its messages are still queued.
+  queue.reset();
+  release.set_value();
+
+  CHECK(waitFor([&ran] { return ran == 41; }));
+}